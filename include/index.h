@@ -9,10 +9,8 @@
 #include "index/BwTree/bwtree.h"
 #include "index/masstree/mtIndexAPI.hh"
 #include "index/hot/src/wrapper.h"
-#ifdef STRING_KEY
-#include "index/blink-hash-str/lib/tree.h"
-#else
 #include "index/blink-hash/lib/tree.h"
+#ifndef STRING_KEY
 #include "index/blink-buffer/lib/run.h"
 #include "index/blink-buffer-batch/lib/run.h"
 #endif
@@ -36,6 +34,32 @@ class Index
 	virtual uint64_t find_bwtree_fast(KeyType key, std::vector<uint64_t> *v) {};
 	virtual bool insert_bwtree_fast(KeyType key, uint64_t value) {};
 
+	// Batched insertion, falls back to per-key insert by default
+	virtual bool insert_batch(kvpair_t<KeyType>* kv, int num, threadinfo *ti) {
+	    for(int i=0; i<num; i++)
+		insert(kv[i].key, kv[i].value, ti);
+	    return 0;
+	}
+
+	// Batched point lookup, found[i] tells a missing key from a stored 0
+	// Falls back to per-key find by default, which can only report a miss
+	// for indexes whose find leaves v empty on one (BlinkHashIndex)
+	virtual void find_batch(KeyType* keys, uint64_t* values, bool* found, int num, threadinfo *ti) {
+	    std::vector<uint64_t> v;
+	    for(int i=0; i<num; i++){
+		v.clear();
+		find(keys[i], &v, ti);
+		found[i] = !v.empty();
+		values[i] = found[i] ? v[0] : 0;
+	    }
+	}
+
+	// Builds the empty index bottom-up from keys sorted in ascending order
+	// Returns false if the index has none, the keys are then to be inserted one by one
+	virtual bool bulk_load(kvpair_t<KeyType>* kv, size_t num, int num_thread) {
+	    return false;
+	}
+
 	virtual void getMemory() = 0;
 	virtual void find_depth() = 0;
 	virtual void convert() = 0;
@@ -1125,49 +1149,104 @@ class CuckooIndex : public Index<KeyType, KeyComparator>
 template<typename KeyType, class KeyComparator>
 class BlinkHashIndex: public Index<KeyType, KeyComparator>
 {
+    #ifdef STRING_KEY
+    // the tree stores variable-length keys, copied into the tree on insert
+    using tree_key_t = BLINK_HASH::string_key_t;
+    static tree_key_t tree_key(const KeyType& key){ return BLINK_HASH::make_key(key.data, sizeof(key.data)); }
+    #else
+    using tree_key_t = KeyType;
+    static const KeyType& tree_key(const KeyType& key){ return key; }
+    #endif
+
     public:
 
 	bool insert(KeyType key, uint64_t value, threadinfo *ti) {
-	    auto t = idx->getThreadInfo();
-	    idx->insert(key, value, t);
-	    return 0;
+	    return with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    idx->insert(tree_key(key), value, t);
+		    return 0;
+		    });
 	}
 
+	#ifndef STRING_KEY
+	// kvpair_t and entry_t share the same {key, value} layout
+	bool insert_batch(kvpair_t<KeyType>* kv, int num, threadinfo *ti) {
+	    return with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    idx->insert_batch(reinterpret_cast<BLINK_HASH::entry_t<KeyType, uint64_t>*>(kv), num, t);
+		    return 0;
+		    });
+	}
+	#endif
+
+	// leaves v empty if the key is not found
 	uint64_t find(KeyType key, std::vector<uint64_t> *v, threadinfo *ti) {
-	    auto t = idx->getThreadInfo();
-	    auto ret = idx->lookup(key, t);
+	    uint64_t value;
+	    auto found = with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    return idx->lookup(tree_key(key), value, t);
+		    });
 	    v->clear();
-	    v->push_back(ret);
+	    if(found)
+		v->push_back(value);
 	    return 0;
 	}
 
+	#ifndef STRING_KEY
+	bool bulk_load(kvpair_t<KeyType>* kv, size_t num, int num_thread) {
+	    return idx->bulk_load(reinterpret_cast<BLINK_HASH::entry_t<KeyType, uint64_t>*>(kv), num, FILL_FACTOR, num_thread);
+	}
+	#endif
+
+	#ifndef STRING_KEY
+	void find_batch(KeyType* keys, uint64_t* values, bool* found, int num, threadinfo *ti) {
+	    with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    idx->lookup_batch(keys, values, found, num, t);
+		    return 0;
+		    });
+	}
+	#endif
+
 	bool upsert(KeyType key, uint64_t value, threadinfo *ti) {
-	    auto t = idx->getThreadInfo();
-	    return idx->update(key, value, t);
+	    return with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    return idx->update(tree_key(key), value, t);
+		    });
 	}
 
 	uint64_t scan(KeyType key, int range, threadinfo *ti) {
 	    uint64_t buf[range];
-	    auto t = idx->getThreadInfo();
-	    auto ret = idx->range_lookup(key, range, buf, t);
-	    return ret;
-	}
-
-	BlinkHashIndex(uint64_t kt){
-	    idx = new BLINK_HASH::btree_t<KeyType, uint64_t>();
+	    return with_thread_info([&](BLINK_HASH::ThreadInfo& t){
+		    return idx->range_lookup(tree_key(key), range, buf, t);
+		    });
+	}
+
+	// attach: cache a per-thread epoch handle in AssignGCID instead of building one per operation
+	// background_convert: convert hash leaves in a background thread instead of inside scans
+	// tail_cache: send inserts beyond the rightmost leaf's low key straight to it
+	// sweeper: migrate buckets left linked by leaf splits in a background thread
+	// overflow_util: convert full older hash leaves at least this utilized to btree leaves instead of splitting them (0 = split)
+	BlinkHashIndex(uint64_t kt, bool attach = true, bool background_convert = false, bool tail_cache = true, bool sweeper = false, double overflow_util = 0): attach(attach){
+	    idx = new BLINK_HASH::btree_t<tree_key_t, uint64_t>();
+	    if(background_convert)
+		idx->start_converter();
+	    if(sweeper)
+		idx->start_sweeper();
+	    idx->set_tail_cache(tail_cache);
+	    idx->set_overflow_convert(overflow_util);
 	}
 
 	void getMemory() { 
 	    uint64_t meta_size, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied;
 	    meta_size = structural_data_occupied = structural_data_unoccupied = key_data_occupied = key_data_unoccupied = 0;
 
-	    idx->footprint(meta_size, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied);
+	    uint64_t pool_live, pool_free;
+	    pool_live = pool_free = 0;
+	    idx->footprint(meta_size, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied, pool_live, pool_free);
 	    std::cout << "[Memory Footprint]" << std::endl;
 	    std::cout << "Metadata: \t" << meta_size << std::endl;
 	    std::cout << "Structural_data_occupied: \t" << structural_data_occupied << std::endl;
 	    std::cout << "Structural_data_unoccupied: \t" << structural_data_unoccupied << std::endl;
 	    std::cout << "Key_data_occupied: \t" << key_data_occupied << std::endl;
 	    std::cout << "Key_data_unoccupied: \t" << key_data_unoccupied << std::endl;
+	    std::cout << "Node_pool_live: \t" << pool_live << std::endl;
+	    std::cout << "Node_pool_free: \t" << pool_free << std::endl;
 
 	}
 
@@ -1183,17 +1262,113 @@ class BlinkHashIndex: public Index<KeyType, KeyComparator>
 
 	uint64_t get_outoforder() { return 0; }
 
+	void CollectStatisticalCounter(int){
+	    uint64_t foreground, background;
+	    foreground = background = 0;
+	    idx->convert_stats(foreground, background);
+	    std::cout << "[Conversion]" << std::endl;
+	    std::cout << "Foreground: \t" << foreground << std::endl;
+	    std::cout << "Background: \t" << background << std::endl;
+
+	    // how long leaf splits held up their leaf, in power-of-two cycle buckets
+	    constexpr int buckets = BLINK_HASH::btree_t<tree_key_t, uint64_t>::split_stall_buckets;
+	    uint64_t hist[buckets];
+	    idx->split_stall_stats(hist);
+	    std::cout << "[Split stall (cycles)]" << std::endl;
+	    for(int i=0; i<buckets; i++){
+		if(hist[i])
+		    std::cout << "2^" << i << ": \t" << hist[i] << std::endl;
+	    }
+
+	    uint64_t swept, missed;
+	    idx->sweep_stats(swept, missed);
+	    std::cout << "[Sweeper]" << std::endl;
+	    std::cout << "Swept: \t" << swept << std::endl;
+	    std::cout << "Missed: \t" << missed << std::endl;
+
+	    uint64_t overflow_converted, overflow_split;
+	    idx->overflow_stats(overflow_converted, overflow_split);
+	    std::cout << "[Overflowed older leaves]" << std::endl;
+	    std::cout << "Converted: \t" << overflow_converted << std::endl;
+	    std::cout << "Split: \t" << overflow_split << std::endl;
+
+	    #ifdef BREAKDOWN
+	    const char* causes[BLINK_HASH::RESTART_CAUSES] = {"Version", "Bucket", "Split", "Convert"};
+	    std::cout << "[Restarts]" << std::endl;
+	    for(int i=0; i<BLINK_HASH::RESTART_CAUSES; i++)
+		std::cout << causes[i] << ": \t" << restarts[i] << std::endl;
+	    std::cout << "[Insert traversal]" << std::endl;
+	    std::cout << "Inner node reads per insert: \t" << (inserts ? (double)inner_reads / inserts : 0) << std::endl;
+	    #endif
+	}
+
 	#ifdef BREAKDOWN
 	void get_breakdown(uint64_t& time_traversal, uint64_t& time_abort, uint64_t& time_latch, uint64_t& time_node, uint64_t& time_split, uint64_t& time_consolidation){
+	    idx->get_breakdown(time_traversal, time_abort, time_latch, time_node, time_split, time_consolidation);
+
+	    // restarts and insert traversals of this thread since it last reported, summed up for CollectStatisticalCounter
+	    static thread_local uint64_t reported[BLINK_HASH::RESTART_CAUSES] = {};
+	    uint64_t count[BLINK_HASH::RESTART_CAUSES];
+	    idx->restart_stats(count);
+	    for(int i=0; i<BLINK_HASH::RESTART_CAUSES; i++){
+		restarts[i] += count[i] - reported[i];
+		reported[i] = count[i];
+	    }
+
+	    static thread_local uint64_t reported_inserts = 0, reported_reads = 0;
+	    uint64_t _inserts, _inner_reads;
+	    idx->insert_traversal_stats(_inserts, _inner_reads);
+	    inserts += _inserts - reported_inserts;
+	    inner_reads += _inner_reads - reported_reads;
+	    reported_inserts = _inserts;
+	    reported_reads = _inner_reads;
 	}
 	#endif
 
 
 	void UpdateThreadLocal(size_t thread_num){ }
-	void AssignGCID(size_t thread_id){ }
-	void UnregisterThread(size_t thread_id) { }
+	void AssignGCID(size_t thread_id){
+	    if(attach){
+		UnregisterThread(thread_id);
+		local_thread_info() = {idx, idx->attach_thread()};
+	    }
+	}
+
+	void UnregisterThread(size_t thread_id){
+	    auto& info = local_thread_info();
+	    if(info.tree == idx && info.t != nullptr){
+		idx->detach_thread(info.t);
+		info = {nullptr, nullptr};
+	    }
+	}
 
     private:
-	BLINK_HASH::btree_t<KeyType, uint64_t>* idx;
+	// the handle is shared by every instance on this thread, so it remembers the tree it was attached to
+	struct local_info_t{
+	    BLINK_HASH::btree_t<tree_key_t, uint64_t>* tree;
+	    BLINK_HASH::ThreadInfo* t;
+	};
+
+	static local_info_t& local_thread_info(){
+	    static thread_local local_info_t info = {nullptr, nullptr};
+	    return info;
+	}
+
+	// threads that are not registered to this tree through AssignGCID fall back to a temporary handle
+	template <typename Fn>
+	auto with_thread_info(Fn&& fn){
+	    auto& info = local_thread_info();
+	    if(info.tree == idx && info.t != nullptr)
+		return fn(*info.t);
+	    auto _t = idx->getThreadInfo();
+	    return fn(_t);
+	}
+
+	BLINK_HASH::btree_t<tree_key_t, uint64_t>* idx;
+	bool attach;
+	#ifdef BREAKDOWN
+	std::atomic<uint64_t> restarts[BLINK_HASH::RESTART_CAUSES] = {};
+	std::atomic<uint64_t> inserts{0}, inner_reads{0};
+	#endif
 };
 #endif
@@ -19,6 +19,16 @@ struct options_t{
     bool profile = false;
     uint64_t fuzzy = 0;
     float random = 0.0;
+    uint32_t batch = 1;
+    uint32_t read_batch = 1;
+    bool attach = true;
+    bool bg_convert = false;
+    bool tail_cache = true;
+    bool sweeper = false;
+    float overflow_util = 0.0;
+    uint32_t startup = 0;
+    bool bulk_load = true;
+    uint32_t scan_range = 0;
 
     uint32_t init_num = 10000000;
     uint32_t run_num = 10000000;
@@ -39,7 +49,9 @@ std::ostream& operator<<(std::ostream& os, const options_t& opt){
        << "\tMeasure perf with earliest finished thread: " << opt.earliest << "\n"
        << "\tMeasure memory bandwidth: " << opt.mem << "\n"
        << "\tEnable CPU profiling: " << opt.profile << "\n"
-       << "\tSampling latency: " << opt.sampling_latency;
+       << "\tSampling latency: " << opt.sampling_latency << "\n"
+       << "\tBatch size: " << opt.batch << "\n"
+       << "\tRead batch size: " << opt.read_batch;
     return os;
 }
 
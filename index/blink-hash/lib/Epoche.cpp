@@ -78,36 +78,42 @@ inline void Epoche::exitEpocheAndCleanup(ThreadInfo &epocheInfo) {
         currentEpoche++;
     }
     if (deletionList.thresholdCounter > startGCThreshhold) {
-        if (deletionList.size() == 0) {
-            deletionList.thresholdCounter = 0;
-            return;
-        }
-        deletionList.localEpoche.store(std::numeric_limits<uint64_t>::max());
+        cleanup(epocheInfo);
+    }
+}
 
-        uint64_t oldestEpoche = std::numeric_limits<uint64_t>::max();
-        for (auto &epoche : deletionLists) {
-            auto e = epoche.localEpoche.load();
-            if (e < oldestEpoche) {
-                oldestEpoche = e;
-            }
+// frees the nodes of this thread that no other thread can still see, regardless of the threshold
+inline void Epoche::cleanup(ThreadInfo &epocheInfo) {
+    DeletionList &deletionList = epocheInfo.getDeletionList();
+    if (deletionList.size() == 0) {
+        deletionList.thresholdCounter = 0;
+        return;
+    }
+    deletionList.localEpoche.store(std::numeric_limits<uint64_t>::max());
+
+    uint64_t oldestEpoche = std::numeric_limits<uint64_t>::max();
+    for (auto &epoche : deletionLists) {
+        auto e = epoche.localEpoche.load();
+        if (e < oldestEpoche) {
+            oldestEpoche = e;
         }
+    }
 
-        LabelDelete *cur = deletionList.head(), *next, *prev = nullptr;
-        while (cur != nullptr) {
-            next = cur->next;
+    LabelDelete *cur = deletionList.head(), *next, *prev = nullptr;
+    while (cur != nullptr) {
+        next = cur->next;
 
-            if (cur->epoche < oldestEpoche) {
-                for (std::size_t i = 0; i < cur->nodesCount; ++i) {
-                    operator delete(cur->nodes[i]);
-                }
-                deletionList.remove(cur, prev);
-            } else {
-                prev = cur;
+        if (cur->epoche < oldestEpoche) {
+            for (std::size_t i = 0; i < cur->nodesCount; ++i) {
+                deleteNode(cur->nodes[i]);
             }
-            cur = next;
+            deletionList.remove(cur, prev);
+        } else {
+            prev = cur;
         }
-        deletionList.thresholdCounter = 0;
+        cur = next;
     }
+    deletionList.thresholdCounter = 0;
 }
 
 inline Epoche::~Epoche() {
@@ -125,7 +131,7 @@ inline Epoche::~Epoche() {
 
             assert(cur->epoche < oldestEpoche);
             for (std::size_t i = 0; i < cur->nodesCount; ++i) {
-                operator delete(cur->nodes[i]);
+                deleteNode(cur->nodes[i]);
             }
             d.remove(cur, prev);
             cur = next;
@@ -68,9 +68,13 @@ namespace BLINK_HASH{
 
         size_t startGCThreshhold;
 
+        // frees a retired node, nodes may come from a node pool rather than the global heap
+        void (*deleteNode)(void*);
+
+        static void defaultDeleteNode(void *n) { operator delete(n); }
 
     public:
-        Epoche(size_t startGCThreshhold) : startGCThreshhold(startGCThreshhold) { }
+        Epoche(size_t startGCThreshhold, void (*deleteNode)(void*) = &defaultDeleteNode) : startGCThreshhold(startGCThreshhold), deleteNode(deleteNode) { }
 
         ~Epoche();
 
@@ -80,6 +84,8 @@ namespace BLINK_HASH{
 
         void exitEpocheAndCleanup(ThreadInfo &info);
 
+        void cleanup(ThreadInfo &info);
+
         void showDeleteRatio();
     };
 
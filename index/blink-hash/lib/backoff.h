@@ -0,0 +1,104 @@
+#ifndef BLINK_HASH_BACKOFF_H__
+#define BLINK_HASH_BACKOFF_H__
+
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <immintrin.h>
+#ifdef BACKOFF_PARK
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+namespace BLINK_HASH{
+
+/* why an operation went back to the root */
+enum restart_cause_t{
+    RESTART_VERSION = 0, // a node was locked or changed under the traversal
+    RESTART_BUCKET,      // a hash bucket was locked or changed by another writer
+    RESTART_SPLIT,       // the hash leaf was being split
+    RESTART_CONVERT,     // the hash leaf was being converted, or has been replaced by btree leaves
+    RESTART_CAUSES
+};
+
+/* the lock attempt or validation that failed last on this thread */
+struct conflict_t{
+    restart_cause_t cause;
+    const void* node;  // node whose version failed, nullptr for buckets
+    const void* word;  // lock word, parked on under BACKOFF_PARK
+    uint32_t seen;     // low 32 bits of the lock word as it was seen
+};
+
+struct restart_stats_t{
+    uint64_t count[RESTART_CAUSES];
+    conflict_t last;
+};
+
+/* restarts are only counted where they are reported (BREAKDOWN) or waited on (BACKOFF),
+   the default build keeps no per-thread state on its lock paths */
+#if defined(BREAKDOWN) || defined(BACKOFF)
+// restarts of the calling thread by cause, over every tree it works on
+inline restart_stats_t& thread_restarts(){
+    static thread_local restart_stats_t stats{};
+    return stats;
+}
+
+inline void conflict(restart_cause_t cause, const void* node, const void* word, uint32_t seen){
+    thread_restarts().last = conflict_t{cause, node, word, seen};
+}
+#else
+inline void conflict(restart_cause_t, const void*, const void*, uint32_t){ }
+#endif
+
+#ifdef BACKOFF
+static constexpr int backoff_max_shift = 10;   // at most 2^10 pauses per restart
+#ifdef BACKOFF_PARK
+static constexpr int backoff_park_after = 8;   // restarts of one operation before it parks
+static constexpr long backoff_park_ns = 20000; // longest park, writers do not wake parked threads
+#endif
+#endif
+
+/* called each time an operation starts over (at its restart label): from the second time on, counts a restart
+   under the cause of the last conflict and waits as the build selects. the default build neither counts nor waits
+   beyond the pause taken where the conflict was found; BREAKDOWN only counts; BACKOFF pauses 2^n times on the n-th restart of the operation,
+   up to 2^backoff_max_shift; BACKOFF_PARK moreover sleeps on the contended lock word past backoff_park_after
+   restarts, until the word changes or backoff_park_ns pass, so that unlocking stays a single add */
+class backoff_t{
+    public:
+	template <typename Classify>
+	void restart(Classify classify){
+	    #if defined(BREAKDOWN) || defined(BACKOFF)
+	    auto& stats = thread_restarts();
+	    if(attempts++ == 0){
+		stats.last = conflict_t{RESTART_VERSION, nullptr, nullptr, 0};
+		return;
+	    }
+	    stats.count[classify(stats.last)]++;
+	    #ifdef BACKOFF
+	    #ifdef BACKOFF_PARK
+	    if((attempts > backoff_park_after) && stats.last.word){
+		struct timespec timeout = {0, backoff_park_ns};
+		syscall(SYS_futex, stats.last.word, FUTEX_WAIT_PRIVATE, stats.last.seen, &timeout, nullptr, 0);
+	    }
+	    else
+	    #endif
+	    {
+		int pauses = 1 << std::min(attempts - 1, backoff_max_shift);
+		for(int i=0; i<pauses; i++)
+		    _mm_pause();
+	    }
+	    #endif
+	    stats.last = conflict_t{RESTART_VERSION, nullptr, nullptr, 0};
+	    #endif
+	}
+
+    #if defined(BREAKDOWN) || defined(BACKOFF)
+    private:
+	int attempts = 0;
+    #endif
+};
+
+}
+#endif
@@ -3,13 +3,85 @@
 
 #include <atomic>
 #include <cstdint>
+#include <immintrin.h>
 
 #include "entry.h"
+#include "backoff.h"
 
 namespace BLINK_HASH{
 
-template <typename Key_t, typename Value_t>
+#ifdef AVX_512
+/* AVX_512 mode keeps the scalar (uint8_t) fingerprint interface and picks the compare at run time,
+   so one binary runs on any x86-64 machine and uses AVX-512BW where the CPU has it */
+enum simd_level_t{
+    SIMD_SSE2 = 0,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+inline simd_level_t detect_simd_level(){
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512bw"))
+	return SIMD_AVX512;
+    if(__builtin_cpu_supports("avx2"))
+	return SIMD_AVX2;
+    return SIMD_SSE2;
+}
+
+// may be lowered (never raised) to compare the paths on one machine
+inline simd_level_t simd_level = detect_simd_level();
+
+// one 64-byte compare: the fingerprints are duplicated into both halves and compared against
+// the fingerprint in the low half and the empty marker in the high half
+__attribute__((target("avx512bw")))
+inline uint64_t fingerprint_probe_avx512(const uint8_t* fingerprints, uint8_t fingerprint, uint8_t empty){
+    __m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fingerprints));
+    __m512i haystack = _mm512_broadcast_i64x4(fingerprints_);
+    __m512i needle = _mm512_inserti64x4(_mm512_set1_epi8(fingerprint), _mm256_set1_epi8(empty), 1);
+    return _mm512_cmpeq_epi8_mask(haystack, needle);
+}
+
+__attribute__((target("avx2")))
+inline uint64_t fingerprint_probe_avx2(const uint8_t* fingerprints, uint8_t fingerprint, uint8_t empty){
+    __m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fingerprints));
+    uint32_t match = _mm256_movemask_epi8(_mm256_cmpeq_epi8(fingerprints_, _mm256_set1_epi8(fingerprint)));
+    uint32_t vacant = _mm256_movemask_epi8(_mm256_cmpeq_epi8(fingerprints_, _mm256_set1_epi8(empty)));
+    return ((uint64_t)vacant << 32) | match;
+}
+
+inline uint64_t fingerprint_probe_sse2(const uint8_t* fingerprints, uint8_t fingerprint, uint8_t empty){
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fingerprints));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fingerprints + 16));
+    __m128i f = _mm_set1_epi8(fingerprint);
+    __m128i e = _mm_set1_epi8(empty);
+    uint32_t match = _mm_movemask_epi8(_mm_cmpeq_epi8(lo, f)) | (_mm_movemask_epi8(_mm_cmpeq_epi8(hi, f)) << 16);
+    uint32_t vacant = _mm_movemask_epi8(_mm_cmpeq_epi8(lo, e)) | (_mm_movemask_epi8(_mm_cmpeq_epi8(hi, e)) << 16);
+    return ((uint64_t)vacant << 32) | match;
+}
+
+inline uint64_t fingerprint_probe(const uint8_t* fingerprints, uint8_t fingerprint, uint8_t empty){
+    switch(simd_level){
+	case SIMD_AVX512:
+	    return fingerprint_probe_avx512(fingerprints, fingerprint, empty);
+	case SIMD_AVX2:
+	    return fingerprint_probe_avx2(fingerprints, fingerprint, empty);
+	default:
+	    return fingerprint_probe_sse2(fingerprints, fingerprint, empty);
+    }
+}
+#endif
+
+template <typename Key_t, typename Value_t, int EntryNum>
 struct bucket_t{
+    static constexpr int entry_num = EntryNum;
+    #ifdef FINGERPRINT
+    #if defined AVX_256 || defined AVX_512
+    static_assert(EntryNum == 32, "AVX_256 and AVX_512 probe exactly 32 fingerprints per bucket");
+    #elif defined AVX_128
+    static_assert(EntryNum % 16 == 0, "AVX_128 probes fingerprints 16 at a time");
+    #endif
+    #endif
+
     enum state_t{
 	STABLE = 0,
 	LINKED_LEFT,
@@ -26,6 +98,9 @@ struct bucket_t{
     entry_t<Key_t, Value_t> entry[entry_num];
 
     bucket_t(): lock(0){
+	#ifdef LINKED
+	state = STABLE;
+	#endif
 	#ifdef FINGERPRINT
 	memset(fingerprints, 0, sizeof(uint8_t)*entry_num);
 	#else
@@ -42,10 +117,13 @@ struct bucket_t{
 
     bool try_lock(){
 	auto version = lock.load();
-	if(is_locked(version))
+	if(is_locked(version)){
+	    conflict(RESTART_BUCKET, nullptr, &lock, version);
 	    return false;
+	}
 
 	if(!lock.compare_exchange_strong(version, version + 0b10)){
+	    conflict(RESTART_BUCKET, nullptr, &lock, version);
 	    _mm_pause();
 	    return false;
 	}
@@ -55,10 +133,13 @@ struct bucket_t{
 
     bool upgrade_lock(uint32_t version){
 	auto _version = lock.load();
-	if(_version != version)
+	if(_version != version){
+	    conflict(RESTART_BUCKET, nullptr, &lock, _version);
 	    return false;
+	}
 
 	if(!lock.compare_exchange_strong(_version, _version + 0b10)){
+	    conflict(RESTART_BUCKET, nullptr, &lock, _version);
 	    _mm_pause();
 	    return false;
 	}
@@ -72,13 +153,22 @@ struct bucket_t{
 
     uint32_t get_version(bool& need_restart){
 	auto version = lock.load();
-	if(is_locked(version))
+	if(is_locked(version)){
+	    conflict(RESTART_BUCKET, nullptr, &lock, version);
 	    need_restart = true;
+	}
 
 	return version;
     }
 
 
+#if defined FINGERPRINT && defined AVX_512
+    /* low 32 bits: slots holding fingerprint, high 32 bits: empty slots */
+    uint64_t probe(uint8_t fingerprint, uint8_t empty){
+	return fingerprint_probe(fingerprints, fingerprint, empty);
+    }
+#endif
+
 #ifdef FINGERPRINT
     #ifdef AVX_256
     bool insert(Key_t key, Value_t value, uint8_t fingerprint, __m256i empty){
@@ -98,7 +188,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     bool insert(Key_t key, Value_t value, uint8_t fingerprint, __m128i empty){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -115,6 +205,17 @@ struct bucket_t{
 	}
 	return false;
     }
+    #elif defined AVX_512
+    bool insert(Key_t key, Value_t value, uint8_t fingerprint, uint8_t empty){
+	uint32_t bitfield = probe(fingerprint, empty) >> 32;
+	if(bitfield == 0)
+	    return false;
+	auto i = __builtin_ctz(bitfield);
+	fingerprints[i] = fingerprint;
+	entry[i].key = key;
+	entry[i].value = value;
+	return true;
+    }
     #else
     bool insert(Key_t key, Value_t value, uint8_t fingerprint, uint8_t empty){
 	for(int i=0; i<entry_num; i++){
@@ -161,7 +262,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     bool find(Key_t key, Value_t& value, __m128i fingerprint){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(fingerprint, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -178,6 +279,17 @@ struct bucket_t{
 	}
 	return false;
     }
+    #elif defined AVX_512
+    bool find(Key_t key, Value_t& value, uint8_t fingerprint){
+	for(uint32_t bitfield = (uint32_t)probe(fingerprint, 0); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    if(entry[i].key == key){
+		value = entry[i].value;
+		return true;
+	    }
+	}
+	return false;
+    }
     #else
     bool find(Key_t key, Value_t& value, uint8_t fingerprint){
 	for(int i=0; i<entry_num; i++){
@@ -219,7 +331,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     void collect(Key_t key, entry_t<Key_t, Value_t>* buf, int& num, __m128i empty){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -233,6 +345,14 @@ struct bucket_t{
 	    }
 	}
     }
+    #elif defined AVX_512
+    void collect(Key_t key, entry_t<Key_t, Value_t>* buf, int& num, uint8_t empty){
+	for(uint32_t bitfield = ~(uint32_t)(probe(empty, empty) >> 32); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    if(entry[i].key >= key)
+		memcpy(&buf[num++], &entry[i], sizeof(entry_t<Key_t, Value_t>));
+	}
+    }
     #else
     void collect(Key_t key, entry_t<Key_t, Value_t>* buf, int& num, uint8_t empty){
 	for(int i=0; i<entry_num; i++){
@@ -268,7 +388,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     void collect(entry_t<Key_t, Value_t>* buf, int& num, __m128i empty){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -281,6 +401,13 @@ struct bucket_t{
 	    }
 	}
     }
+    #elif defined AVX_512
+    void collect(entry_t<Key_t, Value_t>* buf, int& num, uint8_t empty){
+	for(uint32_t bitfield = ~(uint32_t)(probe(empty, empty) >> 32); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    memcpy(&buf[num++], &entry[i], sizeof(entry_t<Key_t, Value_t>));
+	}
+    }
     #else
     void collect(entry_t<Key_t, Value_t>* buf, int& num, uint8_t empty){
 	for(int i=0; i<entry_num; i++){
@@ -317,7 +444,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     bool update(Key_t key, Value_t value, __m128i fingerprint){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(fingerprint, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -334,6 +461,17 @@ struct bucket_t{
 	}
 	return false;
     }
+    #elif defined AVX_512
+    bool update(Key_t key, Value_t value, uint8_t fingerprint){
+	for(uint32_t bitfield = (uint32_t)probe(fingerprint, 0); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    if(entry[i].key == key){
+		entry[i].value = value;
+		return true;
+	    }
+	}
+	return false;
+    }
     #else
     bool update(Key_t key, Value_t value, uint8_t fingerprint){
 	for(int i=0; i<entry_num; i++){
@@ -378,7 +516,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     bool remove(Key_t key, __m128i fingerprint){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(fingerprint, fingerprints_);
 	    uint32_t bitfield = _mm_movemask_epi8(cmp);
@@ -395,6 +533,17 @@ struct bucket_t{
 	}
 	return false;
     }
+    #elif defined AVX_512
+    bool remove(Key_t key, uint8_t fingerprint){
+	for(uint32_t bitfield = (uint32_t)probe(fingerprint, 0); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    if(entry[i].key == key){
+		fingerprints[i] = 0;
+		return true;
+	    }
+	}
+	return false;
+    }
     #else
     bool remove(Key_t key, uint8_t fingerprint){
 	for(int i=0; i<entry_num; i++){
@@ -420,6 +569,25 @@ struct bucket_t{
     }
 #endif
 
+    // clears every entry with a key in [lo, hi], returns how many
+    int remove_range(Key_t lo, Key_t hi){
+	int num = 0;
+	for(int i=0; i<entry_num; i++){
+	#ifdef FINGERPRINT
+	    if((fingerprints[i] != 0) && (lo <= entry[i].key) && (entry[i].key <= hi)){
+		fingerprints[i] = 0;
+		num++;
+	    }
+	#else
+	    if((entry[i].key != EMPTY<Key_t>) && (lo <= entry[i].key) && (entry[i].key <= hi)){
+		entry[i].key = EMPTY<Key_t>;
+		num++;
+	    }
+	#endif
+	}
+	return num;
+    }
+
 
 #ifdef FINGERPRINT
     #ifdef AVX_256
@@ -439,7 +607,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     bool collect_keys(Key_t* keys, int& num, int cardinality, __m128i empty){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 	    uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -455,6 +623,15 @@ struct bucket_t{
 	}
 	return false;
     }
+    #elif defined AVX_512
+    bool collect_keys(Key_t* keys, int& num, int cardinality, uint8_t empty){
+	for(uint32_t bitfield = ~(uint32_t)(probe(empty, empty) >> 32); bitfield; bitfield &= bitfield - 1){
+	    keys[num++] = entry[__builtin_ctz(bitfield)].key;
+	    if(num == cardinality)
+		return true;
+	}
+	return false;
+    }
     #else
     bool collect_keys(Key_t* keys, int& num, int cardinality, uint8_t empty){
 	for(int i=0; i<entry_num; i++){
@@ -495,7 +672,7 @@ struct bucket_t{
     }
     #elif defined AVX_128
     void collect_all_keys(Key_t* keys, int& num, __m128i empty){
-	for(int m=0; m<2; m++){
+	for(int m=0; m<entry_num/16; m++){
 	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(fingerprints + m*16));
 	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 	    uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -508,6 +685,11 @@ struct bucket_t{
 	    }
 	}
     }
+    #elif defined AVX_512
+    void collect_all_keys(Key_t* keys, int& num, uint8_t empty){
+	for(uint32_t bitfield = ~(uint32_t)(probe(empty, empty) >> 32); bitfield; bitfield &= bitfield - 1)
+	    keys[num++] = entry[__builtin_ctz(bitfield)].key;
+    }
     #else
     void collect_all_keys(Key_t* keys, int& num, uint8_t empty){
 	for(int i=0; i<entry_num; i++){
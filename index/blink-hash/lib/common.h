@@ -5,11 +5,13 @@
 #include <cstring>
 #include <string>
 #include <cassert>
+#include "key.h"
 
 namespace BLINK_HASH{
 
 typedef uint64_t key64_t;
 typedef uint64_t value64_t;
+typedef var_key_t string_key_t;
 
 }
 #endif
@@ -0,0 +1,217 @@
+#ifndef BLINK_HASH_ENTRIES_H__
+#define BLINK_HASH_ENTRIES_H__
+
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <immintrin.h>
+#include "entry.h"
+
+namespace BLINK_HASH{
+
+/* SOA_NODE and DELTA_LEAF pick the lower-bound kernel at run time, like the AVX_512 fingerprint compare */
+enum search_level_t{
+    SEARCH_SCALAR = 0,
+    SEARCH_AVX2,
+    SEARCH_AVX512
+};
+
+// the 16-bit compare of delta leaves needs AVX-512BW on top of AVX-512F
+inline search_level_t detect_search_level(){
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+	return SEARCH_AVX512;
+    if(__builtin_cpu_supports("avx2"))
+	return SEARCH_AVX2;
+    return SEARCH_SCALAR;
+}
+
+// may be lowered (never raised) to compare the kernels on one machine
+inline search_level_t search_level = detect_search_level();
+
+// the kernels return how many of the sorted keys[0, cnt) are smaller than key
+template <typename T>
+inline int count_less_scalar(const T* keys, int cnt, T key){
+    for(int i=0; i<cnt; i++){
+	if(key <= keys[i])
+	    return i;
+    }
+    return cnt;
+}
+
+// AVX2 only compares signed integers, so both sides get their sign bit flipped
+__attribute__((target("avx2")))
+inline int count_less_avx2(const uint64_t* keys, int cnt, uint64_t key){
+    const __m256i flip = _mm256_set1_epi64x(INT64_MIN);
+    __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(key), flip);
+    int i = 0;
+    for(; i+4<=cnt; i+=4){
+	__m256i haystack = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+	int less = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, haystack)));
+	if(less != 0xf)
+	    return i + __builtin_popcount(less);
+    }
+    return i + count_less_scalar(keys + i, cnt - i, key);
+}
+
+__attribute__((target("avx2")))
+inline int count_less_avx2(const uint32_t* keys, int cnt, uint32_t key){
+    const __m256i flip = _mm256_set1_epi32(INT32_MIN);
+    __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(key), flip);
+    int i = 0;
+    for(; i+8<=cnt; i+=8){
+	__m256i haystack = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+	int less = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, haystack)));
+	if(less != 0xff)
+	    return i + __builtin_popcount(less);
+    }
+    return i + count_less_scalar(keys + i, cnt - i, key);
+}
+
+// movemask_epi8 yields two bits per 16-bit lane
+__attribute__((target("avx2")))
+inline int count_less_avx2(const uint16_t* keys, int cnt, uint16_t key){
+    const __m256i flip = _mm256_set1_epi16(INT16_MIN);
+    __m256i needle = _mm256_xor_si256(_mm256_set1_epi16(key), flip);
+    int i = 0;
+    for(; i+16<=cnt; i+=16){
+	__m256i haystack = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+	unsigned less = _mm256_movemask_epi8(_mm256_cmpgt_epi16(needle, haystack));
+	if(less != 0xffffffffu)
+	    return i + __builtin_popcount(less) / 2;
+    }
+    return i + count_less_scalar(keys + i, cnt - i, key);
+}
+
+__attribute__((target("avx512f")))
+inline int count_less_avx512(const uint64_t* keys, int cnt, uint64_t key){
+    __m512i needle = _mm512_set1_epi64(key);
+    for(int i=0; i<cnt; i+=8){
+	__mmask8 valid = (cnt - i >= 8) ? 0xff : (__mmask8)((1u << (cnt - i)) - 1);
+	__m512i haystack = _mm512_maskz_loadu_epi64(valid, keys + i);
+	__mmask8 less = _mm512_mask_cmplt_epu64_mask(valid, haystack, needle);
+	if(less != valid)
+	    return i + __builtin_popcount(less);
+    }
+    return cnt;
+}
+
+__attribute__((target("avx512f")))
+inline int count_less_avx512(const uint32_t* keys, int cnt, uint32_t key){
+    __m512i needle = _mm512_set1_epi32(key);
+    for(int i=0; i<cnt; i+=16){
+	__mmask16 valid = (cnt - i >= 16) ? 0xffff : (__mmask16)((1u << (cnt - i)) - 1);
+	__m512i haystack = _mm512_maskz_loadu_epi32(valid, keys + i);
+	__mmask16 less = _mm512_mask_cmplt_epu32_mask(valid, haystack, needle);
+	if(less != valid)
+	    return i + __builtin_popcount(less);
+    }
+    return cnt;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+inline int count_less_avx512(const uint16_t* keys, int cnt, uint16_t key){
+    __m512i needle = _mm512_set1_epi16(key);
+    for(int i=0; i<cnt; i+=32){
+	__mmask32 valid = (cnt - i >= 32) ? 0xffffffffu : (__mmask32)((1u << (cnt - i)) - 1);
+	__m512i haystack = _mm512_maskz_loadu_epi16(valid, keys + i);
+	__mmask32 less = _mm512_mask_cmplt_epu16_mask(valid, haystack, needle);
+	if(less != valid)
+	    return i + __builtin_popcount(less);
+    }
+    return cnt;
+}
+
+template <typename T>
+inline int count_less(const T* keys, int cnt, T key){
+    switch(search_level){
+	case SEARCH_AVX512:
+	    return count_less_avx512(keys, cnt, key);
+	case SEARCH_AVX2:
+	    return count_less_avx2(keys, cnt, key);
+	default:
+	    return count_less_scalar(keys, cnt, key);
+    }
+}
+
+/* sorted key-value array of inner nodes and btree leaves,
+   SOA_NODE keeps keys apart from values so that the lower bound compares a vector of keys at once */
+template <typename Key_t, typename Value_t, size_t N>
+class entries_t{
+    public:
+	#ifdef SOA_NODE
+	Key_t& key(int i){ return keys[i]; }
+
+	Value_t& value(int i){ return values[i]; }
+
+	void move(int to, int from, int num){
+	    memmove(&keys[to], &keys[from], sizeof(Key_t)*num);
+	    memmove(&values[to], &values[from], sizeof(Value_t)*num);
+	}
+
+	void copy(int to, const entries_t& src, int from, int num){
+	    memcpy(&keys[to], &src.keys[from], sizeof(Key_t)*num);
+	    memcpy(&values[to], &src.values[from], sizeof(Value_t)*num);
+	}
+
+	void load(int to, const entry_t<Key_t, Value_t>* buf, int num){
+	    for(int i=0; i<num; i++){
+		keys[to+i] = buf[i].key;
+		values[to+i] = buf[i].value;
+	    }
+	}
+
+	void store(entry_t<Key_t, Value_t>* buf, int from, int num) const{
+	    for(int i=0; i<num; i++){
+		buf[i].key = keys[from+i];
+		buf[i].value = values[from+i];
+	    }
+	}
+
+	// first position whose key is not smaller than key
+	int lower_bound(Key_t key, int cnt) const{
+	    if constexpr(std::is_same<Key_t, uint64_t>::value)
+		return count_less(keys, cnt, key);
+	    for(int i=0; i<cnt; i++){
+		if(key <= keys[i])
+		    return i;
+	    }
+	    return cnt;
+	}
+
+	const void* address(int i) const{ return &keys[i]; }
+	#else
+	Key_t& key(int i){ return entry[i].key; }
+
+	Value_t& value(int i){ return entry[i].value; }
+
+	void move(int to, int from, int num){
+	    memmove(&entry[to], &entry[from], sizeof(entry_t<Key_t, Value_t>)*num);
+	}
+
+	void copy(int to, const entries_t& src, int from, int num){
+	    memcpy(&entry[to], &src.entry[from], sizeof(entry_t<Key_t, Value_t>)*num);
+	}
+
+	void load(int to, const entry_t<Key_t, Value_t>* buf, int num){
+	    memcpy(&entry[to], buf, sizeof(entry_t<Key_t, Value_t>)*num);
+	}
+
+	void store(entry_t<Key_t, Value_t>* buf, int from, int num) const{
+	    memcpy(buf, &entry[from], sizeof(entry_t<Key_t, Value_t>)*num);
+	}
+
+	const void* address(int i) const{ return &entry[i]; }
+	#endif
+
+    private:
+	#ifdef SOA_NODE
+	Key_t keys[N];
+	Value_t values[N];
+	#else
+	entry_t<Key_t, Value_t> entry[N];
+	#endif
+};
+
+}
+#endif
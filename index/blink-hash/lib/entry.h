@@ -3,8 +3,6 @@
 
 namespace BLINK_HASH{
 
-static constexpr int entry_num = 32;
-
 template <typename Key_t, typename Value_t>
 struct entry_t{
     Key_t key;
@@ -2,7 +2,9 @@
 #define UTIL_HASH_H_
 
 #include <functional>
+#include <cstdint>
 #include <stddef.h>
+#include <type_traits>
 namespace BLINK_HASH{
 
 inline size_t standard(const void* _ptr, size_t _len, size_t _seed=static_cast<size_t>(0xc70f6907UL));
@@ -62,5 +64,37 @@ size_t h(const void* key, size_t len, int func_num, size_t seed);
 
 size_t h(const void* key, size_t len, int func_num);
 
+/* hash functions of lnode_hash_t, picked at compile time by key type;
+   hash(key, func_num) returns the func_num-th hash of key.
+   keys without a specialization go through the byte-oriented table above */
+template <typename Key_t, typename = void>
+struct hasher_t{
+    static inline size_t hash(const Key_t& key, int func_num){
+	return h(&key, sizeof(Key_t), func_num);
+    }
+};
+
+/* 64-bit integer keys: xor with a per-function seed, then the splitmix64 finalizer
+   (multiply-xorshift, bijective), inlined and without a loop over the key bytes */
+template <typename Key_t>
+struct hasher_t<Key_t, typename std::enable_if<std::is_integral<Key_t>::value && sizeof(Key_t) == 8>::type>{
+    static constexpr uint64_t seeds[4] = {
+	0x9e3779b97f4a7c15ULL,
+	0xc2b2ae3d27d4eb4fULL,
+	0x165667b19e3779f9ULL,
+	0xd6e8feb86659fd93ULL
+    };
+
+    static inline size_t hash(Key_t key, int func_num){
+	uint64_t x = static_cast<uint64_t>(key) ^ seeds[func_num];
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+    }
+};
+
 }
 #endif  // UTIL_HASH_H_
@@ -2,77 +2,81 @@
 
 namespace BLINK_HASH{
 
-template <typename Key_t>
-inline bool inode_t<Key_t>::is_full(){
+template <typename Key_t, typename Geometry_t>
+inline bool inode_t<Key_t, Geometry_t>::is_full(){
     return (cnt == cardinality);
 }
 
-template <typename Key_t>
-inline int inode_t<Key_t>::find_lowerbound(Key_t& key){
+template <typename Key_t, typename Geometry_t>
+inline int inode_t<Key_t, Geometry_t>::find_lowerbound(Key_t& key){
+    #ifdef SOA_NODE
+    return entry.lower_bound(key, cnt) - 1;
+    #else
     return lowerbound_linear(key);
+    #endif
 }
 
-template <typename Key_t>
-inline node_t* inode_t<Key_t>::scan_node(Key_t key){
+template <typename Key_t, typename Geometry_t>
+inline node_t* inode_t<Key_t, Geometry_t>::scan_node(Key_t key){
     if(sibling_ptr && (high_key < key))
 	return sibling_ptr;
     else{
 	int idx = find_lowerbound(key);
 	if(idx > -1)
-	    return entry[idx].value;
+	    return entry.value(idx);
 	else
 	    return leftmost_ptr;
     }
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::insert(Key_t key, node_t* value){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::insert(Key_t key, node_t* value){
     int pos = find_lowerbound(key);
-    memmove(&entry[pos+2], &entry[pos+1], sizeof(entry_t<Key_t, node_t*>)*(cnt-pos-1));
-    entry[pos+1].key = key;
-    entry[pos+1].value = value;
+    entry.move(pos+2, pos+1, cnt-pos-1);
+    entry.key(pos+1) = key;
+    entry.value(pos+1) = value;
     cnt++;
 
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::insert(Key_t key, node_t* value, node_t* left){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::insert(Key_t key, node_t* value, node_t* left){
     int pos = find_lowerbound(key);
-    memmove(&entry[pos+2], &entry[pos+1], sizeof(entry_t<Key_t, node_t*>)*(cnt-pos-1));
-    entry[pos].value = left;
-    entry[pos+1].key = key;
-    entry[pos+1].value = value;
+    entry.move(pos+2, pos+1, cnt-pos-1);
+    entry.value(pos) = left;
+    entry.key(pos+1) = key;
+    entry.value(pos+1) = value;
 }
 
-template <typename Key_t>
-inode_t<Key_t>* inode_t<Key_t>::split(Key_t& split_key){
+template <typename Key_t, typename Geometry_t>
+inode_t<Key_t, Geometry_t>* inode_t<Key_t, Geometry_t>::split(Key_t& split_key){
     int half = cnt/2;
-    split_key = entry[half].key;
+    split_key = entry.key(half);
 
     int new_cnt = cnt-half-1;
-    auto new_node = new inode_t<Key_t>(sibling_ptr, new_cnt, entry[half].value, level, high_key);
-    memcpy(new_node->entry, entry+half+1, sizeof(entry_t<Key_t, node_t*>)*new_cnt);
+    auto new_node = new inode_t<Key_t, Geometry_t>(sibling_ptr, new_cnt, entry.value(half), level, high_key);
+    new_node->entry.copy(0, entry, half+1, new_cnt);
 
     sibling_ptr = static_cast<node_t*>(new_node);
-    high_key = entry[half].key;
+    high_key = entry.key(half);
     cnt = half;
     return new_node;
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::batch_migrate(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_migrate(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num){
     leftmost_ptr = migrate[migrate_idx++].value;
     int copy_num = migrate_num - migrate_idx;
-    memcpy(entry, &migrate[migrate_idx], sizeof(entry_t<Key_t, node_t*>) * copy_num);
+    entry.load(0, &migrate[migrate_idx], copy_num);
     cnt += copy_num;
     migrate_idx += copy_num;
 }
 
-template <typename Key_t>
-bool inode_t<Key_t>::batch_kvpair(Key_t* key, node_t** value, int& idx, int num, int batch_size){
+template <typename Key_t, typename Geometry_t>
+bool inode_t<Key_t, Geometry_t>::batch_kvpair(Key_t* key, node_t** value, int& idx, int num, int batch_size){
     for(; cnt<batch_size && idx<num-1; cnt++, idx++){
-	entry[cnt].key = key[idx];
-	entry[cnt].value = value[idx];
+	entry.key(cnt) = key[idx];
+	entry.value(cnt) = value[idx];
     }
 
     if(cnt == batch_size){ // insert in the next node
@@ -80,17 +84,17 @@ bool inode_t<Key_t>::batch_kvpair(Key_t* key, node_t** value, int& idx, int num,
 	return true;
     }
     
-    entry[cnt].key = key[idx];
-    entry[cnt].value = value[idx];
+    entry.key(cnt) = key[idx];
+    entry.value(cnt) = value[idx];
     cnt++, idx++;
     return false;
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::batch_buffer(entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num, int batch_size){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_buffer(entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num, int batch_size){
     for(; cnt<batch_size && buf_idx<buf_num-1; cnt++, buf_idx++){
-	entry[cnt].key = buf[buf_idx].key;
-	entry[cnt].value = buf[buf_idx].value;
+	entry.key(cnt) = buf[buf_idx].key;
+	entry.value(cnt) = buf[buf_idx].value;
     }
 
     if(cnt == batch_size){ // insert in the next node
@@ -98,14 +102,14 @@ void inode_t<Key_t>::batch_buffer(entry_t<Key_t, node_t*>* buf, int& buf_idx, in
 	return;
     }
     
-    entry[cnt].key = buf[buf_idx].key;
-    entry[cnt].value = buf[buf_idx].value;
+    entry.key(cnt) = buf[buf_idx].key;
+    entry.value(cnt) = buf[buf_idx].value;
     cnt++, buf_idx++;
 }
 
 // batch insert with migration and movement
-template <typename Key_t>
-void inode_t<Key_t>::batch_insert_last_level(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num, Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_insert_last_level(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num, Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
     bool from_start = true;
     if(migrate_idx < migrate_num){
 	from_start = false;
@@ -135,8 +139,8 @@ void inode_t<Key_t>::batch_insert_last_level(entry_t<Key_t, node_t*>* migrate, i
 }
 
 // batch insert with and movement
-template <typename Key_t>
-void inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_insert_last_level(Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
     bool from_start = true;
     if(idx < num){
 	leftmost_ptr = value[idx++];
@@ -159,8 +163,8 @@ void inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** value, int& id
     }
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::calculate_node_num(int total_num, int& numerator, int& remains, int& last_chunk, int& new_num, int batch_size){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::calculate_node_num(int total_num, int& numerator, int& remains, int& last_chunk, int& new_num, int batch_size){
     if(numerator == 0){ // need only one new node
 	new_num = 1;
 	last_chunk = remains;
@@ -183,8 +187,8 @@ void inode_t<Key_t>::calculate_node_num(int total_num, int& numerator, int& rema
     }
 }
 
-template <typename Key_t>
-inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** value, int num, int& new_num){
+template <typename Key_t, typename Geometry_t>
+inode_t<Key_t, Geometry_t>** inode_t<Key_t, Geometry_t>::batch_insert_last_level(Key_t* key, node_t** value, int num, int& new_num){
     int pos = find_lowerbound(key[0]);
     int batch_size = cardinality * FILL_FACTOR;
     bool inplace = (cnt + num) < cardinality ? 1 : 0;
@@ -195,16 +199,16 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** va
     else
 	move_num = cnt-pos-1;
 
-    if(inplace){ // normal insertion
-	move_normal_insertion(pos, num, move_num);
+    if(inplace){ // normal insertion, value[0] replaces the converted leaf and the other num-1 are new
+	move_normal_insertion(pos, num-1, move_num);
 	if(pos < 0) // leftmost ptr
 	    leftmost_ptr = value[idx++];
 	else
-	    entry[pos].value = value[idx++];
+	    entry.value(pos) = value[idx++];
 
-	for(int i=pos+1; i<pos+num+1; i++, idx++){
-	    entry[i].key = key[idx];
-	    entry[i].value = value[idx];
+	for(int i=pos+1; i<pos+num; i++, idx++){
+	    entry.key(i) = key[idx];
+	    entry.value(i) = value[idx];
 	}
 	cnt += num-1;
 	return nullptr;
@@ -214,26 +218,26 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** va
 	if(pos < 0) // leftmost ptr
 	    leftmost_ptr = value[idx++];
 	else
-	    entry[pos].value = value[idx++];
+	    entry.value(pos) = value[idx++];
 
 	if(batch_size < pos){ // need insert in the middle (migrated + new kvs + moved)
-	    int migrate_num = pos - batch_size;
+	    int migrate_num = pos - batch_size + 1; // entry pos moves along with the ones before it
 	    entry_t<Key_t, node_t*> migrate[migrate_num];
-	    memcpy(migrate, &entry[batch_size], sizeof(entry_t<Key_t, node_t*>) * migrate_num);
+	    entry.store(migrate, batch_size, migrate_num);
 
 	    entry_t<Key_t, node_t*> buf[move_num];
-	    memcpy(buf, &entry[pos+1], sizeof(entry_t<Key_t, node_t*>) * move_num);
+	    entry.store(buf, pos+1, move_num);
 	    cnt = batch_size;
 
-	    int total_num = num + move_num + migrate_num;
+	    int total_num = num - 1 + move_num + migrate_num; // value[0] already sits in migrate
 	    int last_chunk = 0;
 	    int numerator = total_num / (batch_size+1);
 	    int remains = total_num % (batch_size+1);
 	    calculate_node_num(total_num, numerator, remains, last_chunk, new_num, batch_size);
 
-	    auto new_nodes = new inode_t<Key_t>*[new_num];
+	    auto new_nodes = new inode_t<Key_t, Geometry_t>*[new_num];
 	    for(int i=0; i<new_num; i++)
-		new_nodes[i] = new inode_t<Key_t>(level);
+		new_nodes[i] = new inode_t<Key_t, Geometry_t>(level);
 
 	    auto old_sibling = sibling_ptr;
 	    sibling_ptr = static_cast<node_t*>(new_nodes[0]);
@@ -254,17 +258,17 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** va
 	else{ // need insert in the middle (new_kvs + moved)
 	    int move_idx = 0;
 	    entry_t<Key_t, node_t*> buf[move_num];
-	    memcpy(buf, &entry[pos+1], sizeof(entry_t<Key_t, node_t*>) * move_num);
+	    entry.store(buf, pos+1, move_num);
 
 	    for(int i=pos+1; i<batch_size && idx<num; i++, idx++){
-		entry[i].key = key[idx];
-		entry[i].value = value[idx];
+		entry.key(i) = key[idx];
+		entry.value(i) = value[idx];
 	    }
 
 	    cnt += (idx - move_num - 1);
 	    for(; cnt<batch_size; cnt++, move_idx++){
-		entry[cnt].key = buf[move_idx].key;
-		entry[cnt].value = buf[move_idx].value;
+		entry.key(cnt) = buf[move_idx].key;
+		entry.value(cnt) = buf[move_idx].value;
 	    }
 
 	    if(idx < num)
@@ -278,9 +282,9 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** va
 	    int remains = total_num % (batch_size+1);
 	    calculate_node_num(total_num, numerator, remains, last_chunk, new_num, batch_size);
 
-	    auto new_nodes = new inode_t<Key_t>*[new_num];
+	    auto new_nodes = new inode_t<Key_t, Geometry_t>*[new_num];
 	    for(int i=0; i<new_num; i++)
-		new_nodes[i] = new inode_t<Key_t>(level);
+		new_nodes[i] = new inode_t<Key_t, Geometry_t>(level);
 
 	    auto old_sibling = sibling_ptr;
 	    sibling_ptr = static_cast<node_t*>(new_nodes[0]);
@@ -298,8 +302,8 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert_last_level(Key_t* key, node_t** va
 }
 
 // batch insert with migration and movement
-template <typename Key_t>
-void inode_t<Key_t>::batch_insert(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num, Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_insert(entry_t<Key_t, node_t*>* migrate, int& migrate_idx, int migrate_num, Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
     bool from_start = true;
     if(migrate_idx < migrate_num){
 	from_start = false;
@@ -326,8 +330,8 @@ void inode_t<Key_t>::batch_insert(entry_t<Key_t, node_t*>* migrate, int& migrate
 }
 
 // batch insert with and movement
-template <typename Key_t>
-void inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::batch_insert(Key_t* key, node_t** value, int& idx, int num, int batch_size, entry_t<Key_t, node_t*>* buf, int& buf_idx, int buf_num){
     bool from_start = true;
     if(idx < num){
 	from_start = false;
@@ -348,8 +352,8 @@ void inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int& idx, int num,
     }
 }
 
-template <typename Key_t>
-inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int num, int& new_num){
+template <typename Key_t, typename Geometry_t>
+inode_t<Key_t, Geometry_t>** inode_t<Key_t, Geometry_t>::batch_insert(Key_t* key, node_t** value, int num, int& new_num){
     int pos = find_lowerbound(key[0]);
     int batch_size = cardinality * FILL_FACTOR;
     bool inplace = (cnt + num) < cardinality ? 1 : 0;
@@ -363,20 +367,20 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int nu
     if(inplace){
 	move_normal_insertion(pos, num, move_num);
 	for(int i=pos+1; i<pos+num+1; i++, idx++){
-	    entry[i].key = key[idx];
-	    entry[i].value = value[idx];
+	    entry.key(i) = key[idx];
+	    entry.value(i) = value[idx];
 	}
 	cnt += num;
 	return nullptr;
     }
     else{
 	if(batch_size < pos){ // need insert in the middle (migrated + new kvs + moved)
-	    int migrate_num = pos - batch_size;
+	    int migrate_num = pos - batch_size + 1; // entry pos moves along with the ones before it
 	    entry_t<Key_t, node_t*> migrate[migrate_num];
-	    memcpy(migrate, &entry[batch_size], sizeof(entry_t<Key_t, node_t*>) * migrate_num);
+	    entry.store(migrate, batch_size, migrate_num);
 
 	    entry_t<Key_t, node_t*> buf[move_num];
-	    memcpy(buf, &entry[pos+1], sizeof(entry_t<Key_t, node_t*>) * move_num);
+	    entry.store(buf, pos+1, move_num);
 	    cnt = batch_size;
 
 	    int total_num = num + move_num + migrate_num;
@@ -385,9 +389,9 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int nu
 	    int remains = total_num % (batch_size+1);
 	    calculate_node_num(total_num, numerator, remains, last_chunk, new_num, batch_size);
 
-	    auto new_nodes = new inode_t<Key_t>*[new_num];
+	    auto new_nodes = new inode_t<Key_t, Geometry_t>*[new_num];
 	    for(int i=0; i<new_num; i++)
-		new_nodes[i] = new inode_t<Key_t>(level);
+		new_nodes[i] = new inode_t<Key_t, Geometry_t>(level);
 
 	    auto old_sibling = sibling_ptr;
 	    sibling_ptr = static_cast<node_t*>(new_nodes[0]);
@@ -409,17 +413,17 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int nu
 	else{ // need insert in the middle (new_kvs + moved)
 	    int move_idx = 0;
 	    entry_t<Key_t, node_t*> buf[move_num];
-	    memcpy(buf, &entry[pos+1], sizeof(entry_t<Key_t, node_t*>)*move_num);
+	    entry.store(buf, pos+1, move_num);
 
 	    for(int i=pos+1; i<batch_size && idx<num; i++, idx++){
-		entry[i].key = key[idx];
-		entry[i].value = value[idx];
+		entry.key(i) = key[idx];
+		entry.value(i) = value[idx];
 	    }
 
 	    cnt += (idx - move_num);
 	    for(; cnt<batch_size; cnt++, move_idx++){
-		entry[cnt].key = buf[move_idx].key;
-		entry[cnt].value = buf[move_idx].value;
+		entry.key(cnt) = buf[move_idx].key;
+		entry.value(cnt) = buf[move_idx].value;
 	    }
 	    auto prev_high_key = high_key;
 
@@ -434,9 +438,9 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int nu
 	    int remains = total_num % (batch_size+1);
 	    calculate_node_num(total_num, numerator, remains, last_chunk, new_num, batch_size);
 
-	    auto new_nodes = new inode_t<Key_t>*[new_num];
+	    auto new_nodes = new inode_t<Key_t, Geometry_t>*[new_num];
 	    for(int i=0; i<new_num; i++)
-		new_nodes[i] = new inode_t<Key_t>(level);
+		new_nodes[i] = new inode_t<Key_t, Geometry_t>(level);
 
 	    auto old_sibling = sibling_ptr;
 	    sibling_ptr = static_cast<node_t*>(new_nodes[0]);
@@ -453,77 +457,152 @@ inode_t<Key_t>** inode_t<Key_t>::batch_insert(Key_t* key, node_t** value, int nu
     }
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::insert_for_root(Key_t* key, node_t** value, node_t* left, int num){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::insert_for_root(Key_t* key, node_t** value, node_t* left, int num){
     leftmost_ptr = left;
     for(int i=0; i<num; i++, cnt++){
-	entry[cnt].key = key[i];
-	entry[cnt].value = value[i];
+	entry.key(cnt) = key[i];
+	entry.value(cnt) = value[i];
+    }
+}
+
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::bulk_load(Key_t* key, node_t** value, int& idx, int num, int batch_size){
+    int buf_idx = 0;
+    batch_insert(key, value, idx, num, batch_size, nullptr, buf_idx, 0);
+}
+
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::move_normal_insertion(int pos, int num, int move_num){
+    entry.move(pos+num+1, pos+1, move_num);
+}
+
+template <typename Key_t, typename Geometry_t>
+node_t* inode_t<Key_t, Geometry_t>::rightmost_ptr(){
+    if(cnt == 0) // every other child has been merged away
+	return leftmost_ptr;
+    return entry.value(cnt-1);
+}
+
+template <typename Key_t, typename Geometry_t>
+node_t* inode_t<Key_t, Geometry_t>::child(int pos){
+    if(pos < 0)
+	return leftmost_ptr;
+    return entry.value(pos);
+}
+
+template <typename Key_t, typename Geometry_t>
+Key_t inode_t<Key_t, Geometry_t>::separator(int pos){
+    return entry.key(pos);
+}
+
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::set_separator(int pos, Key_t key){
+    entry.key(pos) = key;
+}
+
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::remove_at(int pos){
+    entry.move(pos, pos+1, cnt-pos-1);
+    cnt--;
+}
+
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::remove_children(int from, int num){
+    if(from < 0){ // the child right of the removed ones becomes the leftmost, its separator goes too
+	leftmost_ptr = entry.value(num-1);
+	from = 0;
     }
+    entry.move(from, from+num, cnt-from-num);
+    cnt -= num;
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::move_normal_insertion(int pos, int num, int move_num){
-    memmove(&entry[pos+num+1], &entry[pos+1], sizeof(entry_t<Key_t, node_t*>)*move_num);
+template <typename Key_t, typename Geometry_t>
+bool inode_t<Key_t, Geometry_t>::merge(inode_t<Key_t, Geometry_t>* right, Key_t separator){
+    if(cnt + 1 + right->cnt > cardinality * FILL_FACTOR)
+	return false;
+    entry.key(cnt) = separator;
+    entry.value(cnt) = right->leftmost_ptr;
+    entry.copy(cnt+1, right->entry, 0, right->cnt);
+    cnt += 1 + right->cnt;
+    high_key = right->high_key;
+    sibling_ptr = right->sibling_ptr;
+    return true;
 }
 
-template <typename Key_t>
-node_t* inode_t<Key_t>::rightmost_ptr(){
-    return entry[cnt-1].value;
+// buf[0] holds leftmost_ptr of this node and buf[cnt+1] the separator and leftmost_ptr of right
+template <typename Key_t, typename Geometry_t>
+Key_t inode_t<Key_t, Geometry_t>::rebalance(inode_t<Key_t, Geometry_t>* right, Key_t separator){
+    int num = cnt + right->cnt + 2;
+    entry_t<Key_t, node_t*> buf[num];
+    buf[0].value = leftmost_ptr;
+    entry.store(&buf[1], 0, cnt);
+    buf[cnt+1].key = separator;
+    buf[cnt+1].value = right->leftmost_ptr;
+    right->entry.store(&buf[cnt+2], 0, right->cnt);
+
+    int half = num/2;
+    entry.load(0, &buf[1], half-1);
+    cnt = half-1;
+    high_key = buf[half].key;
+    right->leftmost_ptr = buf[half].value;
+    right->entry.load(0, &buf[half+1], num-half-1);
+    right->cnt = num-half-1;
+    return high_key;
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::print(){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::print(){
     std::cout << leftmost_ptr;
     for(int i=0; i<cnt; i++){
-	std::cout << " [" << i << "]" << entry[i].key << " " << entry[i].value << ", ";
+	std::cout << " [" << i << "]" << entry.key(i) << " " << entry.value(i) << ", ";
     }
     std::cout << "  high_key: " << high_key << "\n\n";
 }
 
-template <typename Key_t>
-void inode_t<Key_t>::sanity_check(Key_t _high_key, bool first){
+template <typename Key_t, typename Geometry_t>
+void inode_t<Key_t, Geometry_t>::sanity_check(Key_t _high_key, bool first){
     for(int i=0; i<cnt-1; i++){
 	for(int j=i+1; j<cnt; j++){
-	    if(entry[i].key > entry[j].key){
+	    if(entry.key(i) > entry.key(j)){
 		std::cout << "inode_t::key order is not preserved!!" << std::endl;
-		std::cout << "[" << i << "].key: " << entry[i].key << "\t[" << j << "].key: " << entry[j].key << " at node " << this << std::endl;
+		std::cout << "[" << i << "].key: " << entry.key(i) << "\t[" << j << "].key: " << entry.key(j) << " at node " << this << std::endl;
 	    }
 	}
     }
     for(int i=0; i<cnt; i++){
-	if(sibling_ptr && (entry[i].key > high_key)){
-	    std::cout << "inode_t:: " << i << "(" << entry[i].key << ") is higher than high key " << high_key << "at node " << this << std::endl;
+	if(sibling_ptr && (entry.key(i) > high_key)){
+	    std::cout << "inode_t:: " << i << "(" << entry.key(i) << ") is higher than high key " << high_key << "at node " << this << std::endl;
 	}
 	if(!first){
-	    if(sibling_ptr && (entry[i].key <= _high_key)){
-		std::cout << "inode_t:: " << i << "(" << entry[i].key << ") is smaller than previous high key " << _high_key << std::endl;
+	    if(sibling_ptr && (entry.key(i) <= _high_key)){
+		std::cout << "inode_t:: " << i << "(" << entry.key(i) << ") is smaller than previous high key " << _high_key << std::endl;
 		std::cout << "--------- node_address " << this << " , current high_key " << high_key << std::endl;
 	    }
 	}
     }
     if(sibling_ptr != nullptr)
-	(static_cast<inode_t<Key_t>*>(sibling_ptr))->sanity_check(high_key, false);
+	(static_cast<inode_t<Key_t, Geometry_t>*>(sibling_ptr))->sanity_check(high_key, false);
 }
 
-template <typename Key_t>
-inline int inode_t<Key_t>::lowerbound_linear(Key_t key){
+template <typename Key_t, typename Geometry_t>
+inline int inode_t<Key_t, Geometry_t>::lowerbound_linear(Key_t key){
     int count = cnt;
     for(int i=0; i<count; i++){
-	if(key <= entry[i].key){
+	if(key <= entry.key(i)){
 	    return i-1;
 	}
     }
     return count-1;
 }
 
-template <typename Key_t>
-inline int inode_t<Key_t>::lowerbound_binary(Key_t key){
+template <typename Key_t, typename Geometry_t>
+inline int inode_t<Key_t, Geometry_t>::lowerbound_binary(Key_t key){
     int lower = 0;
     int upper = cnt;
     do{
 	int mid = ((upper - lower)/2) + lower;
-	if(key <= entry[mid].key)
+	if(key <= entry.key(mid))
 	    upper = mid;
 	else
 	    lower = mid+1;
@@ -531,5 +610,11 @@ inline int inode_t<Key_t>::lowerbound_binary(Key_t key){
     return lower-1;
 }
 
-template class inode_t<key64_t>;
+template class inode_t<key64_t, default_geometry_t>;
+template class inode_t<key64_t, leaf_64k_geometry_t>;
+template class inode_t<key64_t, leaf_1m_geometry_t>;
+template class inode_t<key64_t, page_1k_geometry_t>;
+template class inode_t<key64_t, slot_8_geometry_t>;
+
+template class inode_t<string_key_t, default_geometry_t>;
 }
@@ -2,17 +2,17 @@
 #define BLINK_HASH_INODE_H__
 
 #include "node.h"
-#include "entry.h"
+#include "entries.h"
 
 namespace BLINK_HASH{
     
-template <typename Key_t>
+template <typename Key_t, typename Geometry_t = default_geometry_t>
 class inode_t : public node_t{
     public:
-        static constexpr size_t cardinality = (PAGE_SIZE - sizeof(node_t)- sizeof(Key_t)) / sizeof(entry_t<Key_t, node_t*>);
+        static constexpr size_t cardinality = (Geometry_t::page_size - sizeof(node_t)- sizeof(Key_t)) / sizeof(entry_t<Key_t, node_t*>);
 	Key_t high_key;
     private:
-        entry_t<Key_t, node_t*> entry[cardinality];
+        entries_t<Key_t, node_t*, cardinality> entry;
     public:
 
         inode_t() { }
@@ -26,8 +26,8 @@ class inode_t : public node_t{
         // constructor when tree height grows
         inode_t(Key_t split_key, node_t* left, node_t* right, node_t* sibling, int _level, Key_t _high_key): node_t(sibling, left, 1, _level){
             high_key = _high_key;
-            entry[0].value = right;
-            entry[0].key = split_key;
+            entry.value(0) = right;
+            entry.key(0) = split_key;
         }
 
         bool is_full();
@@ -40,16 +40,39 @@ class inode_t : public node_t{
 
         void insert(Key_t key, node_t* value, node_t* left);
 
-	inode_t<Key_t>* split(Key_t& split_key);
+	inode_t<Key_t, Geometry_t>* split(Key_t& split_key);
 
 	void insert_for_root(Key_t* key, node_t** value, node_t* left, int num);
 
-	inode_t<Key_t>** batch_insert_last_level(Key_t* key, node_t** value, int num, int& new_num);
+	/* fills this empty node with the children of a level built bottom-up from value[idx] on, key[i] separating value[i]
+	   from the child before it; takes batch_size+1 children at most and leaves idx at the first one of the next node */
+	void bulk_load(Key_t* key, node_t** value, int& idx, int num, int batch_size);
 
-	inode_t<Key_t>** batch_insert(Key_t* key, node_t** value, int num, int& new_num);
+	inode_t<Key_t, Geometry_t>** batch_insert_last_level(Key_t* key, node_t** value, int num, int& new_num);
+
+	inode_t<Key_t, Geometry_t>** batch_insert(Key_t* key, node_t** value, int num, int& new_num);
 
 	node_t* rightmost_ptr();
 
+	// child right of separator pos, pos -1 is leftmost_ptr
+	node_t* child(int pos);
+
+	Key_t separator(int pos);
+
+	void set_separator(int pos, Key_t key);
+
+	// drops separator pos together with the child right of it
+	void remove_at(int pos);
+
+	// drops num children from child from on (-1 is leftmost_ptr) together with the separators left of them
+	void remove_children(int from, int num);
+
+	/* appends separator and the children of right, the sibling of this node, if they fit */
+	bool merge(inode_t<Key_t, Geometry_t>* right, Key_t separator);
+
+	/* evens out the children of this node and its sibling right, returns the separator between them */
+	Key_t rebalance(inode_t<Key_t, Geometry_t>* right, Key_t separator);
+
         void print();
 
 	void sanity_check(Key_t _high_key, bool first);
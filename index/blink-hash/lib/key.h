@@ -0,0 +1,210 @@
+#ifndef BLINK_HASH_KEY_H__
+#define BLINK_HASH_KEY_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include "hash.h"
+
+namespace BLINK_HASH{
+
+/* variable-length string key (no NUL bytes) in 16 bytes;
+   prefix holds the first 8 bytes big-endian and zero padded, so most comparisons end with one integer compare.
+   keys of up to 15 bytes are inline: bit 63 of tail set, the length in bits 56-59, bytes 8-14 big-endian in bits 0-55.
+   longer keys keep the length in bits 48-62 and point at their bytes in bits 0-47 */
+struct var_key_t{
+    static constexpr size_t inline_max = 15;
+    static constexpr size_t length_max = (1 << 15) - 1;
+    static constexpr uint64_t inline_bit = 1ULL << 63;
+    static constexpr uint64_t inline_mask = (1ULL << 56) - 1;
+    static constexpr uint64_t ptr_mask = (1ULL << 48) - 1;
+
+    uint64_t prefix;
+    uint64_t tail;
+
+    var_key_t() = default;
+
+    /* refers to data for keys longer than inline_max, which has to outlive the key (see key_arena_t) */
+    var_key_t(const char* data, size_t len){
+	assert(len <= length_max);
+	prefix = load_be(data, std::min(len, (size_t)8));
+	if(len <= inline_max)
+	    tail = inline_bit | ((uint64_t)len << 56) | (load_be(data + 8, len > 8 ? len - 8 : 0) >> 8);
+	else{
+	    assert(((uintptr_t)data & ~ptr_mask) == 0);
+	    tail = ((uint64_t)len << 48) | (uintptr_t)data;
+	}
+    }
+
+    inline bool is_inline() const{ return tail & inline_bit; }
+
+    inline size_t size() const{
+	return is_inline() ? (tail >> 56) & 0xf : (tail >> 48) & length_max;
+    }
+
+    /* bytes of the key, inline keys are spelled out into buf (inline_max+1 bytes) */
+    inline const char* data(char* buf) const{
+	if(!is_inline())
+	    return reinterpret_cast<const char*>(tail & ptr_mask);
+	uint64_t hi = __builtin_bswap64(prefix);
+	uint64_t lo = __builtin_bswap64((tail & inline_mask) << 8);
+	memcpy(buf, &hi, 8);
+	memcpy(buf + 8, &lo, 8);
+	return buf;
+    }
+
+    /* compares the bytes past the prefix, both keys being out of line or the prefixes equal */
+    static int compare_tail(const var_key_t& a, const var_key_t& b){
+	char abuf[16], bbuf[16];
+	auto alen = a.size();
+	auto blen = b.size();
+	auto adata = a.data(abuf);
+	auto bdata = b.data(bbuf);
+	auto len = std::min(alen, blen);
+	if(len > 8){
+	    int cmp = memcmp(adata + 8, bdata + 8, len - 8);
+	    if(cmp != 0)
+		return cmp;
+	}
+	return (alen > blen) - (alen < blen);
+    }
+
+    inline bool operator<(const var_key_t& other) const{
+	if(prefix != other.prefix)
+	    return prefix < other.prefix;
+	if(tail & other.tail & inline_bit)
+	    return (tail & inline_mask) < (other.tail & inline_mask);
+	return compare_tail(*this, other) < 0;
+    }
+
+    inline bool operator==(const var_key_t& other) const{
+	if(prefix != other.prefix)
+	    return false;
+	if(tail == other.tail)
+	    return true;
+	if((tail | other.tail) & inline_bit) // inline keys are equal only bitwise
+	    return false;
+	return (size() == other.size()) && (compare_tail(*this, other) == 0);
+    }
+
+    inline bool operator>(const var_key_t& other) const{ return other < *this; }
+    inline bool operator!=(const var_key_t& other) const{ return !(*this == other); }
+    inline bool operator<=(const var_key_t& other) const{ return !(other < *this); }
+    inline bool operator>=(const var_key_t& other) const{ return !(*this < other); }
+
+    friend std::ostream& operator<<(std::ostream& os, const var_key_t& key){
+	char buf[16];
+	return os.write(key.data(buf), key.size());
+    }
+
+    private:
+	static inline uint64_t load_be(const char* data, size_t len){
+	    uint64_t word = 0;
+	    memcpy(&word, data, len);
+	    return __builtin_bswap64(word);
+	}
+};
+
+/* fingerprints and bucket positions come from the whole key rather than the 16 bytes stored in the node */
+template <>
+struct hasher_t<var_key_t>{
+    static inline size_t hash(const var_key_t& key, int func_num){
+	char buf[16];
+	return h(key.data(buf), key.size(), func_num);
+    }
+};
+
+/* append-only storage for the bytes of keys longer than var_key_t::inline_max;
+   separators and converted leaves share them, so they are freed only with the arena */
+class key_arena_t{
+    public:
+	static constexpr size_t chunk_size = 1 << 20;
+
+	~key_arena_t(){
+	    for(auto chunk: chunks)
+		free(chunk);
+	}
+
+	var_key_t copy(const var_key_t& key){
+	    if(key.is_inline())
+		return key;
+	    auto len = key.size();
+	    auto dst = alloc(len + 1);
+	    memcpy(dst, key.data(nullptr), len);
+	    dst[len] = '\0';
+	    return var_key_t(dst, len);
+	}
+
+	/* bytes handed out to keys */
+	uint64_t size(){ return used.load(); }
+
+    private:
+	struct chunk_t{
+	    std::atomic<size_t> offset;
+	    char* data(){ return reinterpret_cast<char*>(this + 1); }
+	};
+
+	std::mutex mutex;
+	std::vector<chunk_t*> chunks;
+	std::atomic<chunk_t*> cur{nullptr};
+	std::atomic<uint64_t> used{0};
+
+	char* alloc(size_t len){
+	    len = (len + 7) & ~(size_t)7;
+	    assert(len <= chunk_size);
+	    while(true){
+		auto chunk = cur.load();
+		if(chunk){
+		    auto off = chunk->offset.fetch_add(len);
+		    if(off + len <= chunk_size){
+			used.fetch_add(len);
+			return chunk->data() + off;
+		    }
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if(cur.load() == chunk){ // nobody replaced the full chunk in the meantime
+		    auto fresh = static_cast<chunk_t*>(malloc(sizeof(chunk_t) + chunk_size));
+		    new (&fresh->offset) std::atomic<size_t>(0);
+		    chunks.push_back(fresh);
+		    cur.store(fresh);
+		}
+	    }
+	}
+};
+
+/* properties of a key type the tree relies on beyond ordering (operator<, ==) and hashing (hasher_t, which the
+   fingerprints are taken from); EMPTY<Key_t>, the zero key, marks free hash slots and must not be a valid key.
+   the defaults fit integers and other fixed-size keys held whole in the node */
+template <typename Key_t>
+struct key_traits_t{
+    // DELTA_LEAF converts hash leaves to delta-encoded leaves, which subtract keys
+    static constexpr bool delta = std::is_integral<Key_t>::value;
+    // the node holds the whole key, so nodes can be written to and mapped from a file
+    static constexpr bool flat = true;
+    // copies whatever the key refers to into storage of the tree before the key is stored in a node
+    static inline Key_t store(key_arena_t& arena, const Key_t& key){ return key; }
+};
+
+template <>
+struct key_traits_t<var_key_t>{
+    static constexpr bool delta = false;
+    static constexpr bool flat = false;
+    static inline var_key_t store(key_arena_t& arena, const var_key_t& key){ return arena.copy(key); }
+};
+
+/* key of the NUL-terminated string in data (at most len bytes), refers to data until it is inserted */
+inline var_key_t make_key(const char* data, size_t len){
+    return var_key_t(data, strnlen(data, len));
+}
+
+}
+#endif
@@ -1,17 +1,19 @@
 #include "lnode.h"
 #include "lnode_btree.cpp"
 #include "lnode_hash.cpp"
+#include "lnode_delta.cpp"
 
 namespace BLINK_HASH{
 
-template <typename Key_t, typename Value_t>
-inline void lnode_t<Key_t, Value_t>::write_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_t<Key_t, Value_t, Geometry_t>::write_unlock(){
     switch(type){
 	case BTREE_NODE:
+	case DELTA_NODE:
 	    (static_cast<node_t*>(this))->write_unlock();
 	    return;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->split_unlock();
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->split_unlock();
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -21,14 +23,15 @@ inline void lnode_t<Key_t, Value_t>::write_unlock(){
     return;
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_t<Key_t, Value_t>::convert_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_t<Key_t, Value_t, Geometry_t>::convert_unlock(){
     switch(type){
 	case BTREE_NODE:
+	case DELTA_NODE:
 	    (static_cast<node_t*>(this))->write_unlock();
 	    return;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->convert_unlock();
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->convert_unlock();
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -38,14 +41,15 @@ inline void lnode_t<Key_t, Value_t>::convert_unlock(){
     return;
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_t<Key_t, Value_t>::write_unlock_obsolete(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_t<Key_t, Value_t, Geometry_t>::write_unlock_obsolete(){
     switch(type){
 	case BTREE_NODE:
+	case DELTA_NODE:
 	    (static_cast<node_t*>(this))->write_unlock_obsolete();
 	    return;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->split_unlock_obsolete();
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->split_unlock_obsolete();
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -55,14 +59,15 @@ inline void lnode_t<Key_t, Value_t>::write_unlock_obsolete(){
     return;
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_t<Key_t, Value_t>::convert_unlock_obsolete(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_t<Key_t, Value_t, Geometry_t>::convert_unlock_obsolete(){
     switch(type){
 	case BTREE_NODE:
+	case DELTA_NODE:
 	    (static_cast<node_t*>(this))->write_unlock_obsolete();
 	    return;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->convert_unlock_obsolete();
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->convert_unlock_obsolete();
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -72,13 +77,17 @@ inline void lnode_t<Key_t, Value_t>::convert_unlock_obsolete(){
     return;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::insert(Key_t key, Value_t value, uint64_t version){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->insert(key, value, version);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->insert(key, value, version);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->insert(key, value, version);
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->insert(key, value, version);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->insert(key, value, version);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return 0;
@@ -87,13 +96,36 @@ int lnode_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t version){
     return 0;
 }
 
-template <typename Key_t, typename Value_t>
-node_t* lnode_t<Key_t, Value_t>::split(Key_t& split_key, Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->split(split_key, key, value);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->insert_batch(buf, num, inserted, version);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->insert_batch(buf, num, inserted, version);
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->split(split_key, key, value, version);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->insert_batch(buf, num, inserted, version);
+	default:
+	    std::cerr << __func__ << ": node type error: " << type << std::endl;
+	    return 0;
+    }
+    std::cerr << __func__ << ": should not reach here" << std::endl;
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+node_t* lnode_t<Key_t, Value_t, Geometry_t>::split(Key_t& split_key, Key_t key, Value_t value, uint64_t version){
+    switch(type){
+	case BTREE_NODE:
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->split(split_key, key, value);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->split(split_key, key, value);
+	    break;
+	case HASH_NODE:
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->split(split_key, key, value, version);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return nullptr;
@@ -102,13 +134,17 @@ node_t* lnode_t<Key_t, Value_t>::split(Key_t& split_key, Key_t key, Value_t valu
     return nullptr;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::update(Key_t key, Value_t value, uint64_t version){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->update(key, value, version);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->update(key, value, version);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->update(key, value, version);
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->update(key, value, version);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->update(key, value, version);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return 0;
@@ -117,13 +153,17 @@ int lnode_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t version){
     return 0;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_t<Key_t, Value_t>::remove(Key_t key, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::remove(Key_t key, uint64_t version){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->remove(key, version);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->remove(key, version);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->remove(key, version);
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->remove(key, version);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->remove(key, version);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return 0;
@@ -132,32 +172,67 @@ int lnode_t<Key_t, Value_t>::remove(Key_t key, uint64_t version){
     return 0;
 }
 
-template <typename Key_t, typename Value_t>
-Value_t lnode_t<Key_t, Value_t>::find(Key_t key, bool& need_restart){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_t<Key_t, Value_t, Geometry_t>::find(Key_t key, Value_t& value, bool& need_restart){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->find(key);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->find(key, value, need_restart);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->find(key, value);
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->find(key, need_restart);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->find(key, value, need_restart);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
-	    return 0;
+	    return false;
     }
     std::cerr << __func__ << ": should not reach here" << std::endl;
-    return 0;
+    return false;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_t<Key_t, Value_t, Geometry_t>::prefetch(Key_t key){
+    switch(type){
+	case BTREE_NODE:
+	    (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->prefetch(key);
+	    return;
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta){
+		(static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->prefetch(key);
+		return;
+	    }
+	    break;
+	case HASH_NODE:
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->prefetch(key);
+	    return;
+	default:
+	    return;
+    }
+}
+
+// btree leaves split under their own write lock, there is nothing to help with
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_t<Key_t, Value_t, Geometry_t>::help_split(){
+    if(type == HASH_NODE)
+	(static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->help_split();
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->range_lookup(key, buf, count, range, continued);
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->range_lookup(key, buf, count, range, continued);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->range_lookup(key, buf, count, range, continued);
+	    break;
 	case HASH_NODE:
 	    #ifdef ADAPTATION
 	    if(sibling_ptr != nullptr) // convert flag
 		return -2;
 	    #endif
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->range_lookup(key, buf, count, range);
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->range_lookup(key, buf, count, range);
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return 0;
@@ -166,14 +241,103 @@ int lnode_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int count, in
     return 0;
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_t<Key_t, Value_t>::print(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::merge(lnode_t<Key_t, Value_t, Geometry_t>* right, double min_util, Key_t& separator){
+    if(right->utilization() == 0)
+	return 1;
+    if(type != right->type)
+	return -1;
+    bool underfull = (utilization() < min_util) || (right->utilization() < min_util);
+    switch(type){
+	case BTREE_NODE:{
+	    auto left = static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this);
+	    auto _right = static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(right);
+	    if(left->merge(_right))
+		return 1;
+	    if(!underfull)
+		return -1;
+	    left->rebalance(_right);
+	    separator = high_key;
+	    return 0;
+	}
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta){
+		auto left = static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this);
+		auto _right = static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(right);
+		if(left->merge(_right))
+		    return 1;
+		if(!underfull || !left->rebalance(_right))
+		    return -1;
+		separator = high_key;
+		return 0;
+	    }
+	    return -1;
+	default: // hash leaves only give way when empty
+	    return -1;
+    }
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::remove_range(Key_t lo, Key_t hi){
     switch(type){
 	case BTREE_NODE:
-	    (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->print();
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->remove_range(lo, hi);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->remove_range(lo, hi);
+	    break;
+	case HASH_NODE:
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->remove_range(lo, hi);
+	default:
+	    std::cerr << __func__ << ": node type error: " << type << std::endl;
+	    return 0;
+    }
+    std::cerr << __func__ << ": should not reach here" << std::endl;
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::count(){
+    if(type == HASH_NODE)
+	return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->count();
+    return this->cnt;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_t<Key_t, Value_t, Geometry_t>::collect(entry_t<Key_t, Value_t>* buf){
+    switch(type){
+	case BTREE_NODE:
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->collect(buf);
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta){
+		(static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->decode(buf);
+		return this->cnt;
+	    }
+	    break;
+	case HASH_NODE:
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->collect(buf);
+	default:
+	    std::cerr << __func__ << ": node type error: " << type << std::endl;
+	    return 0;
+    }
+    std::cerr << __func__ << ": should not reach here" << std::endl;
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_t<Key_t, Value_t, Geometry_t>::print(){
+    switch(type){
+	case BTREE_NODE:
+	    (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->print();
 	    return;
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta){
+		(static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->print();
+		return;
+	    }
+	    break;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->print();
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->print();
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -182,14 +346,20 @@ void lnode_t<Key_t, Value_t>::print(){
     std::cerr << __func__ << ": should not reach here" << std::endl;
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_t<Key_t, Value_t>::sanity_check(Key_t key, bool first){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_t<Key_t, Value_t, Geometry_t>::sanity_check(Key_t key, bool first){
     switch(type){
 	case BTREE_NODE:
-	    (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->sanity_check(key, first);
+	    (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->sanity_check(key, first);
 	    return;
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta){
+		(static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->sanity_check(key, first);
+		return;
+	    }
+	    break;
 	case HASH_NODE:
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->sanity_check(key, first);
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->sanity_check(key, first);
 	    return;
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
@@ -198,13 +368,17 @@ void lnode_t<Key_t, Value_t>::sanity_check(Key_t key, bool first){
     std::cerr << __func__ << ": should not reach here" << std::endl;
 }
 
-template <typename Key_t, typename Value_t>
-double lnode_t<Key_t, Value_t>::utilization(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double lnode_t<Key_t, Value_t, Geometry_t>::utilization(){
     switch(type){
 	case BTREE_NODE:
-	    return (static_cast<lnode_btree_t<Key_t, Value_t>*>(this))->utilization();
+	    return (static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(this))->utilization();
+	case DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		return (static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(this))->utilization();
+	    break;
 	case HASH_NODE:
-	    return (static_cast<lnode_hash_t<Key_t, Value_t>*>(this))->utilization();
+	    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this))->utilization();
 	default:
 	    std::cerr << __func__ << ": node type error: " << type << std::endl;
 	    return 0;
@@ -213,5 +387,11 @@ double lnode_t<Key_t, Value_t>::utilization(){
     return 0;
 }
 
-template class lnode_t<key64_t, value64_t>;
+template class lnode_t<key64_t, value64_t, default_geometry_t>;
+template class lnode_t<key64_t, value64_t, leaf_64k_geometry_t>;
+template class lnode_t<key64_t, value64_t, leaf_1m_geometry_t>;
+template class lnode_t<key64_t, value64_t, page_1k_geometry_t>;
+template class lnode_t<key64_t, value64_t, slot_8_geometry_t>;
+
+template class lnode_t<string_key_t, value64_t, default_geometry_t>;
 }
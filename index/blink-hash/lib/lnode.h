@@ -3,21 +3,20 @@
 
 #include "node.h"
 #include "bucket.h"
+#include "pool.h"
+#include "entries.h"
 
 namespace BLINK_HASH{
 
-#define LEAF_BTREE_SIZE (PAGE_SIZE)
-#define LEAF_HASH_SIZE (1024 * 256)
 #define SEED (0xc70697UL)
-#define HASH_FUNCS_NUM (2)
-#define NUM_SLOT (4)
 
-template <typename Key_t, typename Value_t>
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
 class lnode_t : public node_t{
     public:
 	enum node_type_t{
 	    BTREE_NODE = 0,
-	    HASH_NODE
+	    HASH_NODE,
+	    DELTA_NODE
 	};
 
 	node_type_t type;
@@ -41,16 +40,34 @@ class lnode_t : public node_t{
 
 	int insert(Key_t key, Value_t value, uint64_t version);
 
+	int insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version);
+
 	node_t* split(Key_t& split_key, Key_t key, Value_t value, uint64_t version);
 
 	int update(Key_t key, Value_t value, uint64_t version);
 
 	int remove(Key_t key, uint64_t version);
 
-	Value_t find(Key_t key, bool& need_restart);
+	bool find(Key_t key, Value_t& value, bool& need_restart);
+
+	void prefetch(Key_t key);
+
+	void help_split();
 
 	int range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued);
 
+	/* called with this leaf and its sibling right locked: returns 1 if right is empty or its entries moved here,
+	   0 if the pair was evened out because one of them is below min_util (separator is the new high key), -1 otherwise */
+	int merge(lnode_t<Key_t, Value_t, Geometry_t>* right, double min_util, Key_t& separator);
+
+	/* called with this leaf locked as for a split, removes the keys in [lo, hi] and returns how many */
+	int remove_range(Key_t lo, Key_t hi);
+
+	int count();
+
+	/* called with this leaf locked as for a split, copies its entries sorted by key into buf and returns how many */
+	int collect(entry_t<Key_t, Value_t>* buf);
+
 	void sanity_check(Key_t key, bool first);
 
 	void print();
@@ -59,20 +76,26 @@ class lnode_t : public node_t{
 	
 };
 
-template <typename Key_t, typename Value_t>
-class lnode_btree_t : public lnode_t<Key_t, Value_t>{
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
+class lnode_btree_t : public lnode_t<Key_t, Value_t, Geometry_t>{
     public:
-	static constexpr size_t cardinality = (LEAF_BTREE_SIZE - sizeof(lnode_t<Key_t, Value_t>) - sizeof(size_t)) / sizeof(entry_t<Key_t, Value_t>);
+	static constexpr size_t cardinality = (Geometry_t::leaf_btree_size - sizeof(lnode_t<Key_t, Value_t, Geometry_t>) - sizeof(size_t)) / sizeof(entry_t<Key_t, Value_t>);
     private:
-	entry_t<Key_t, Value_t> entry[cardinality];
+	entries_t<Key_t, Value_t, cardinality> entry;
 
     public:
 
 	// initial constructor
-	lnode_btree_t(): lnode_t<Key_t, Value_t>(lnode_t<Key_t, Value_t>::BTREE_NODE){ }
+	lnode_btree_t(): lnode_t<Key_t, Value_t, Geometry_t>(lnode_t<Key_t, Value_t, Geometry_t>::BTREE_NODE){ }
 
 	// constructor when leaf splits
-	lnode_btree_t(node_t* sibling, int _cnt, int _level): lnode_t<Key_t, Value_t>(sibling, _cnt, _level, lnode_t<Key_t, Value_t>::BTREE_NODE){ }
+	lnode_btree_t(node_t* sibling, int _cnt, int _level): lnode_t<Key_t, Value_t, Geometry_t>(sibling, _cnt, _level, lnode_t<Key_t, Value_t, Geometry_t>::BTREE_NODE){ }
+
+	#ifdef NODE_POOL
+	static void* operator new(size_t size){ return node_pool_t<lnode_btree_t<Key_t, Value_t, Geometry_t>>::allocate(); }
+
+	static void operator delete(void* ptr){ node_pool_t<lnode_btree_t<Key_t, Value_t, Geometry_t>>::deallocate(ptr); }
+	#endif
 
 	void write_unlock();
 
@@ -80,18 +103,34 @@ class lnode_btree_t : public lnode_t<Key_t, Value_t>{
 
 	int find_lowerbound(Key_t key);
 
-	Value_t find(Key_t key);
+	bool find(Key_t key, Value_t& value);
+
+	/* optimistic read: searches under the version taken here and sets need_restart instead of answering
+	   if a writer locked the leaf in the meantime, the caller then retries */
+	bool find(Key_t key, Value_t& value, bool& need_restart);
+
+	void prefetch(Key_t key);
 
 	int insert(Key_t key, Value_t value, uint64_t version);
 
-	lnode_btree_t<Key_t, Value_t>* split(Key_t& split_key, Key_t key, Value_t value);
+	int insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version);
+
+	lnode_btree_t<Key_t, Value_t, Geometry_t>* split(Key_t& split_key, Key_t key, Value_t value);
 	
 	void insert_after_split(Key_t key, Value_t value);
 
-	void batch_insert(entry_t<Key_t, Value_t>* buf, int batch_size, int& from, int to);
+	void batch_insert(const entry_t<Key_t, Value_t>* buf, int batch_size, int& from, int to);
+
+	bool merge(lnode_btree_t<Key_t, Value_t, Geometry_t>* right);
+
+	void rebalance(lnode_btree_t<Key_t, Value_t, Geometry_t>* right);
 
 	int remove(Key_t key, uint64_t version);
 
+	int remove_range(Key_t lo, Key_t hi);
+
+	int collect(entry_t<Key_t, Value_t>* buf);
+
         int update(Key_t key, Value_t value, uint64_t version);
 
         int range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued);
@@ -111,27 +150,155 @@ class lnode_btree_t : public lnode_t<Key_t, Value_t>{
 
         bool update_linear(Key_t key, uint64_t value);
 
-        Value_t find_linear(Key_t key);
+        bool find_linear(Key_t key, Value_t& value, int num);
 
-        Value_t find_binary(Key_t key);
+        bool find_binary(Key_t key, Value_t& value, int num);
 
 	int find_pos_linear(Key_t key);
 
 	int find_pos_binary(Key_t key);
 };
 
-template <typename Key_t, typename Value_t>
-static constexpr size_t FILL_SIZE = lnode_btree_t<Key_t, Value_t>::cardinality * FILL_FACTOR;
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
+static constexpr size_t FILL_SIZE = lnode_btree_t<Key_t, Value_t, Geometry_t>::cardinality * FILL_FACTOR;
 
-template <typename Key_t, typename Value_t>
-class lnode_hash_t : public lnode_t<Key_t, Value_t>{
+/* btree leaf produced by convert under DELTA_LEAF, keys are stored as 2, 4 or 8-byte deltas from the
+   first key (the narrowest width their range fits in), so that a page holds more keys of a dense time range;
+   locked like a btree leaf, inserts re-encode the leaf when the new key widens the range */
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
+class lnode_delta_t : public lnode_t<Key_t, Value_t, Geometry_t>{
     public:
-	static constexpr size_t cardinality = (LEAF_HASH_SIZE - sizeof(lnode_t<Key_t, Value_t>) - sizeof(lnode_t<Key_t, Value_t>*)) / sizeof(bucket_t<Key_t, Value_t>);
+	static_assert(std::is_integral<Key_t>::value, "delta leaves encode integer keys");
+	static constexpr size_t area_size = Geometry_t::leaf_btree_size - sizeof(lnode_t<Key_t, Value_t, Geometry_t>) - sizeof(Key_t) - sizeof(uint64_t);
 
-	lnode_hash_t<Key_t, Value_t>* left_sibling_ptr;
+	static constexpr int capacity(int width){ return area_size / (width + sizeof(Value_t)); }
+
+	static constexpr int fill_size(int width){ return capacity(width) * FILL_FACTOR; }
+
+	// narrowest delta width in bytes that holds every key in [low, high]
+	static int width_for(Key_t low, Key_t high){
+	    uint64_t range = high - low;
+	    if(range <= UINT16_MAX) return 2;
+	    if(range <= UINT32_MAX) return 4;
+	    return 8;
+	}
 
     private:
-	bucket_t<Key_t, Value_t> bucket[cardinality];
+	Key_t base;
+	uint64_t width;
+	// values[capacity(width)] followed by deltas[capacity(width)]
+	alignas(8) uint8_t area[area_size];
+
+    public:
+	// initial constructor
+	lnode_delta_t(): lnode_t<Key_t, Value_t, Geometry_t>(lnode_t<Key_t, Value_t, Geometry_t>::DELTA_NODE), base(0), width(2){ }
+
+	// constructor when leaf splits
+	lnode_delta_t(node_t* sibling, int _level): lnode_t<Key_t, Value_t, Geometry_t>(sibling, 0, _level, lnode_t<Key_t, Value_t, Geometry_t>::DELTA_NODE), base(0), width(2){ }
+
+	#ifdef NODE_POOL
+	static void* operator new(size_t size){ return node_pool_t<lnode_delta_t<Key_t, Value_t, Geometry_t>>::allocate(); }
+
+	static void operator delete(void* ptr){ node_pool_t<lnode_delta_t<Key_t, Value_t, Geometry_t>>::deallocate(ptr); }
+	#endif
+
+	void write_unlock();
+
+	int find_lowerbound(Key_t key);
+
+	bool find(Key_t key, Value_t& value);
+
+	void prefetch(Key_t key);
+
+	int insert(Key_t key, Value_t value, uint64_t version);
+
+	int insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version);
+
+	lnode_delta_t<Key_t, Value_t, Geometry_t>* split(Key_t& split_key, Key_t key, Value_t value);
+
+	// encodes sorted buf[0, num) into this leaf, num must fit the capacity of the width their range needs
+	void encode(const entry_t<Key_t, Value_t>* buf, int num);
+
+	void decode(entry_t<Key_t, Value_t>* buf);
+
+	bool merge(lnode_delta_t<Key_t, Value_t, Geometry_t>* right);
+
+	// fails if either half spans a range too wide for its share of the keys
+	bool rebalance(lnode_delta_t<Key_t, Value_t, Geometry_t>* right);
+
+	int remove(Key_t key, uint64_t version);
+
+	int remove_range(Key_t lo, Key_t hi);
+
+	int update(Key_t key, Value_t value, uint64_t version);
+
+	int range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued);
+
+	void print();
+
+	void sanity_check(Key_t _high_key, bool first);
+
+	int get_cnt();
+
+	int get_width();
+
+	double utilization();
+
+	void footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied);
+
+    private:
+	Value_t* values(){ return reinterpret_cast<Value_t*>(area); }
+
+	uint8_t* delta_area(int _width){ return area + capacity(_width) * sizeof(Value_t); }
+
+	Key_t key_at(int i, int _width);
+
+	void set_key(int i, Key_t key);
+
+	int lowerbound(Key_t key, int cnt, int _width);
+
+	bool insert_locked(Key_t key, Value_t value);
+};
+
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
+class lnode_hash_t : public lnode_t<Key_t, Value_t, Geometry_t>{
+    public:
+	static constexpr int entry_num = Geometry_t::entry_num;
+	static constexpr int num_slot = Geometry_t::num_slot;
+	static constexpr int hash_funcs_num = Geometry_t::hash_funcs_num;
+	#ifdef COOP_SPLIT
+	static constexpr size_t split_meta_size = sizeof(void*) + sizeof(std::atomic<int>);
+	#else
+	static constexpr size_t split_meta_size = 0;
+	#endif
+	static constexpr size_t cardinality = (Geometry_t::leaf_hash_size - sizeof(lnode_t<Key_t, Value_t, Geometry_t>) - sizeof(lnode_t<Key_t, Value_t, Geometry_t>*) - sizeof(uint64_t) - split_meta_size) / sizeof(bucket_t<Key_t, Value_t, Geometry_t::entry_num>);
+	static_assert(hash_funcs_num <= 4, "hasher_t provides 4 hash functions");
+
+	lnode_hash_t<Key_t, Value_t, Geometry_t>* left_sibling_ptr;
+
+	// set while convert holds the leaf and kept once it has been replaced, tells restarts on a locked leaf apart
+	alignas(8) bool converting;
+
+	#ifdef COOP_SPLIT
+	// buckets [next, cardinality) of an eager split still to be migrated, claimed split_chunk at a time
+	struct split_job_t{
+	    lnode_hash_t<Key_t, Value_t, Geometry_t>* new_right;
+	    Key_t split_key;
+	    std::atomic<int> next;
+	    std::atomic<int> done;
+	};
+	static constexpr int split_chunk = 16;
+
+	std::atomic<split_job_t*> split_job{nullptr};
+	std::atomic<int> split_helpers{0};
+	#endif
+
+    private:
+	bucket_t<Key_t, Value_t, Geometry_t::entry_num> bucket[cardinality];
+
+	/* a bucket of a leaf that has not changed since version is only held by another writer for a single
+	   entry, so the caller waits for it here instead of going back to the root; false once the leaf changed */
+	bool lock_bucket(int loc, uint64_t version);
 
     public:
 	bool try_splitlock(uint64_t version);
@@ -151,45 +318,70 @@ class lnode_hash_t : public lnode_t<Key_t, Value_t>{
 	void write_unlock();
 
         // initial constructor
-        lnode_hash_t(): lnode_t<Key_t, Value_t>(lnode_t<Key_t, Value_t>::HASH_NODE) { }
+        lnode_hash_t(): lnode_t<Key_t, Value_t, Geometry_t>(lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE), left_sibling_ptr(nullptr), converting(false) { }
 
         // constructor when leaf splits
-        lnode_hash_t(node_t* sibling, int _cnt, int _level): lnode_t<Key_t, Value_t>(sibling, 0, _level, lnode_t<Key_t, Value_t>::HASH_NODE){
+        lnode_hash_t(node_t* sibling, int _cnt, int _level): lnode_t<Key_t, Value_t, Geometry_t>(sibling, 0, _level, lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE), left_sibling_ptr(nullptr), converting(false){
 	    #ifdef LINKED
             for(int i=0; i<cardinality; i++){
-                bucket[i].state = bucket_t<Key_t, Value_t>::LINKED_LEFT;
+                bucket[i].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_LEFT;
             }
 	    #endif
         }
 
+	#ifdef NODE_POOL
+	static void* operator new(size_t size){ return node_pool_t<lnode_hash_t<Key_t, Value_t, Geometry_t>>::allocate(); }
+
+	static void operator delete(void* ptr){ node_pool_t<lnode_hash_t<Key_t, Value_t, Geometry_t>>::deallocate(ptr); }
+	#endif
+
 	uint8_t _hash(size_t key);
 
 	int insert(Key_t key, Value_t value, uint64_t version);
 
-	lnode_hash_t<Key_t, Value_t>* split(Key_t& split_key, Key_t key, Value_t value, uint64_t version);
+	int insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version);
+
+	lnode_hash_t<Key_t, Value_t, Geometry_t>* split(Key_t& split_key, Key_t key, Value_t value, uint64_t version);
+
+	void help_split();
 
 	int update(Key_t key, Value_t value, uint64_t vstart);
 
 	int remove(Key_t key, uint64_t version);
 
-	Value_t find(Key_t key, bool& need_restart);
+	int remove_range(Key_t lo, Key_t hi);
+
+	bool find(Key_t key, Value_t& value, bool& need_restart);
+
+	void prefetch(Key_t key);
 
 	int range_lookup(Key_t key, Value_t* buf, int count, int range);
 
 	// need to use structure to return output
-	lnode_btree_t<Key_t, Value_t>** convert(int& num, uint64_t version);
+	lnode_t<Key_t, Value_t, Geometry_t>** convert(int& num, uint64_t version);
+
+	int collect(entry_t<Key_t, Value_t>* buf);
 
 	void print();
 
 	void sanity_check(Key_t _high_key, bool first);
 
+        int count();
+
         double utilization();
 
 	void footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied);
 
+	/* migrates every bucket still linked to a sibling by an earlier split, fails if version is stale or a bucket is locked */
+	bool stabilize_all(uint64_t version);
+
     private:
 
-	bool stabilize_all(uint64_t version);
+	void migrate(lnode_hash_t<Key_t, Value_t, Geometry_t>* new_right, Key_t split_key, int from, int to);
+
+	#ifdef COOP_SPLIT
+	void run_split_job(split_job_t* job);
+	#endif
 
 	bool stabilize_bucket(int loc);
 
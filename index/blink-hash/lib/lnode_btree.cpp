@@ -2,34 +2,79 @@
 
 namespace BLINK_HASH{
 
-template <typename Key_t, typename Value_t>
-inline void lnode_btree_t<Key_t, Value_t>::write_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_btree_t<Key_t, Value_t, Geometry_t>::write_unlock(){
     (static_cast<node_t*>(this))->write_unlock();
 }
 
-template <typename Key_t, typename Value_t>
-inline bool lnode_btree_t<Key_t, Value_t>::is_full(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline bool lnode_btree_t<Key_t, Value_t, Geometry_t>::is_full(){
     return (this->cnt == cardinality);
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::find_lowerbound(Key_t key){
-    if constexpr(LEAF_BTREE_SIZE < 2048)
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::find_lowerbound(Key_t key){
+    #ifdef SOA_NODE
+    return entry.lower_bound(key, this->cnt);
+    #else
+    if constexpr(Geometry_t::leaf_btree_size < 2048)
 	return lowerbound_linear(key);
     else
 	return lowerbound_binary(key);
+    #endif
 }
 
-template <typename Key_t, typename Value_t>
-Value_t lnode_btree_t<Key_t, Value_t>::find(Key_t key){
-    if constexpr(LEAF_BTREE_SIZE < 2048)
-	return find_linear(key);
+// cnt is read once and bounded, so that a search racing with a writer stays inside the node
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::find(Key_t key, Value_t& value){
+    int num = *static_cast<volatile int*>(&this->cnt);
+    num = std::min(num, (int)cardinality);
+    #ifdef SOA_NODE
+    int pos = entry.lower_bound(key, num);
+    if(pos < num && entry.key(pos) == key){
+	value = entry.value(pos);
+	return true;
+    }
+    return false;
+    #else
+    if constexpr(Geometry_t::leaf_btree_size < 2048)
+	return find_linear(key, value, num);
     else
-	return find_binary(key);
+	return find_binary(key, value, num);
+    #endif
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::find(Key_t key, Value_t& value, bool& need_restart){
+    auto version = this->try_readlock(need_restart);
+    if(need_restart)
+	return false;
+
+    Value_t _value;
+    bool found = find(key, _value);
+
+    // the reads of the search happen before the version is read again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto _version = this->get_version(need_restart);
+    if(need_restart || (version != _version)){
+	need_restart = true;
+	return false;
+    }
+    if(found)
+	value = _value;
+    return found;
+}
+
+// the node is read without validation, so cnt is only a hint here
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::prefetch(Key_t key){
+    int cnt = this->cnt;
+    if(cnt > 0 && cnt <= (int)cardinality)
+	__builtin_prefetch(entry.address(cnt/2));
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::insert(Key_t key, Value_t value, uint64_t version){
     bool need_restart = false;
     this->try_upgrade_writelock(version, need_restart);
     if(need_restart)
@@ -38,13 +83,13 @@ int lnode_btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t ver
     if(this->cnt < cardinality){
 	if(this->cnt){
 	    int pos = find_lowerbound(key);
-	    memmove(&entry[pos+1], &entry[pos], sizeof(entry_t<Key_t, Value_t>)*(this->cnt-pos));
-	    entry[pos].key = key;
-	    entry[pos].value = value;
+	    entry.move(pos+1, pos, this->cnt-pos);
+	    entry.key(pos) = key;
+	    entry.value(pos) = value;
 	}
 	else{
-	    entry[0].key = key;
-	    entry[0].value= value;
+	    entry.key(0) = key;
+	    entry.value(0)= value;
 	}
 	this->cnt++;
 	this->write_unlock();
@@ -53,25 +98,51 @@ int lnode_btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t ver
     return 1; // need split
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_btree_t<Key_t, Value_t>::insert_after_split(Key_t key, Value_t value){
+// keys in buf are sorted and all belong to this leaf
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version){
+    bool need_restart = false;
+    this->try_upgrade_writelock(version, need_restart);
+    if(need_restart)
+	return -1;
+
+    int pos = 0;
+    for(; inserted<num && this->cnt<cardinality; inserted++){
+	// positions are non-decreasing since the batch is sorted
+	while(pos < this->cnt && entry.key(pos) < buf[inserted].key)
+	    pos++;
+	entry.move(pos+1, pos, this->cnt-pos);
+	entry.key(pos) = buf[inserted].key;
+	entry.value(pos) = buf[inserted].value;
+	this->cnt++;
+	pos++;
+    }
+    this->write_unlock();
+
+    if(inserted < num)
+	return 1; // need split
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::insert_after_split(Key_t key, Value_t value){
     int pos = find_lowerbound(key);
-    memmove(&entry[pos+1], &entry[pos], sizeof(entry_t<Key_t, Value_t>)*(this->cnt - pos));
-    entry[pos].key = key;
-    entry[pos].value = value;
+    entry.move(pos+1, pos, this->cnt - pos);
+    entry.key(pos) = key;
+    entry.value(pos) = value;
     this->cnt++;
 }
 
-template <typename Key_t, typename Value_t>
-lnode_btree_t<Key_t, Value_t>* lnode_btree_t<Key_t, Value_t>::split(Key_t& split_key, Key_t key, Value_t value){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+lnode_btree_t<Key_t, Value_t, Geometry_t>* lnode_btree_t<Key_t, Value_t, Geometry_t>::split(Key_t& split_key, Key_t key, Value_t value){
     int half = this->cnt/2;
     int new_cnt = this->cnt - half;
-    split_key = entry[half-1].key;
+    split_key = entry.key(half-1);
 
-    auto sibling = static_cast<lnode_t<Key_t, Value_t>*>(this->sibling_ptr);
-    auto new_leaf = new lnode_btree_t<Key_t, Value_t>(this->sibling_ptr, new_cnt, this->level);
+    auto sibling = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
+    auto new_leaf = new lnode_btree_t<Key_t, Value_t, Geometry_t>(this->sibling_ptr, new_cnt, this->level);
     new_leaf->high_key = this->high_key;
-    memcpy(new_leaf->entry, entry+half, sizeof(entry_t<Key_t, Value_t>)*new_cnt);
+    new_leaf->entry.copy(0, entry, half, new_cnt);
 
     this->sibling_ptr = static_cast<node_t*>(new_leaf);
     this->high_key = split_key;
@@ -83,32 +154,59 @@ lnode_btree_t<Key_t, Value_t>* lnode_btree_t<Key_t, Value_t>::split(Key_t& split
 	insert_after_split(key, value);
 
     if(sibling){
-	if(sibling->type == lnode_t<Key_t, Value_t>::HASH_NODE)
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(sibling))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t>*>(new_leaf);
+	if(sibling->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(sibling))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(new_leaf);
     }
 
     return new_leaf;
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_btree_t<Key_t, Value_t>::batch_insert(entry_t<Key_t, Value_t>* buf, int batch_size, int& from, int to){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::batch_insert(const entry_t<Key_t, Value_t>* buf, int batch_size, int& from, int to){
     if(from + batch_size < to){
-	memcpy(entry, &buf[from], sizeof(entry_t<Key_t, Value_t>)*batch_size);
+	entry.load(0, &buf[from], batch_size);
 	from += batch_size;
 	this->cnt += batch_size;
-	this->high_key = entry[this->cnt-1].key;
+	this->high_key = entry.key(this->cnt-1);
     }
     else{
-	memcpy(entry, &buf[from], sizeof(entry_t<Key_t, Value_t>)*(to - from));
+	entry.load(0, &buf[from], to - from);
 	this->cnt += (to - from);
 	from = to;
-	this->high_key = entry[this->cnt-1].key;
+	this->high_key = entry.key(this->cnt-1);
     }
 }
 
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::merge(lnode_btree_t<Key_t, Value_t, Geometry_t>* right){
+    if(this->cnt + right->cnt > FILL_SIZE<Key_t, Value_t, Geometry_t>)
+	return false;
+    entry.copy(this->cnt, right->entry, 0, right->cnt);
+    this->cnt += right->cnt;
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::rebalance(lnode_btree_t<Key_t, Value_t, Geometry_t>* right){
+    int total = this->cnt + right->cnt;
+    int half = total/2;
+    if(this->cnt > half){
+	int num = this->cnt - half;
+	right->entry.move(num, 0, right->cnt);
+	right->entry.copy(0, entry, half, num);
+    }
+    else{
+	int num = half - this->cnt;
+	entry.copy(this->cnt, right->entry, 0, num);
+	right->entry.move(0, num, right->cnt - num);
+    }
+    right->cnt = total - half;
+    this->cnt = half;
+    this->high_key = entry.key(half-1);
+}
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::remove(Key_t key, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::remove(Key_t key, uint64_t version){
     bool need_restart = false;
     this->try_upgrade_writelock(version, need_restart);
     if(need_restart) return -1;
@@ -116,8 +214,11 @@ int lnode_btree_t<Key_t, Value_t>::remove(Key_t key, uint64_t version){
     if(this->cnt){
 	int pos = find_pos_linear(key);
 	// no matching key found
-	if(pos == -1) return 1;
-	memmove(&entry[pos], &entry[pos+1], sizeof(entry_t<Key_t, Value_t>)*(lnode_t<Key_t, Value_t>::cnt - pos - 1));
+	if(pos == -1){
+	    write_unlock();
+	    return 1;
+	}
+	entry.move(pos, pos+1, this->cnt - pos - 1);
 	this->cnt--;
 	write_unlock();
 	return 0;
@@ -126,8 +227,25 @@ int lnode_btree_t<Key_t, Value_t>::remove(Key_t key, uint64_t version){
     return 1;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::remove_range(Key_t lo, Key_t hi){
+    int from = find_lowerbound(lo);
+    int to = from;
+    while((to < this->cnt) && (entry.key(to) <= hi))
+	to++;
+    entry.move(from, to, this->cnt - to);
+    this->cnt -= to - from;
+    return to - from;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::collect(entry_t<Key_t, Value_t>* buf){
+    entry.store(buf, 0, this->cnt);
+    return this->cnt;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::update(Key_t key, Value_t value, uint64_t version){
     bool need_restart = false;
     this->try_upgrade_writelock(version, need_restart);
     if(need_restart)
@@ -142,12 +260,12 @@ int lnode_btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t ver
     return 1;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued){
     auto _count = count;
     if(continued){
 	for(int i=0; i<this->cnt; i++){
-	    buf[_count++] = entry[i].value;
+	    buf[_count++] = entry.value(i);
 	    if(_count == range) return _count;
 	}
 	return _count;
@@ -155,73 +273,73 @@ int lnode_btree_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int cou
     else{
 	int pos = find_lowerbound(key);
 	for(int i=pos+1; i<this->cnt; i++){
-	    buf[_count++] = entry[i].value;
+	    buf[_count++] = entry.value(i);
 	    if(_count == range) return _count;
 	}
 	return _count;
     }
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_btree_t<Key_t, Value_t>::print(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::print(){
     for(int i=0; i<this->cnt; i++)
-	std::cout << "[" << i << "]" << entry[i].key << " ";
+	std::cout << "[" << i << "]" << entry.key(i) << " ";
     std::cout << "  high_key: " << this->high_key << "\n\n";
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_btree_t<Key_t, Value_t>::sanity_check(Key_t _high_key, bool first){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_btree_t<Key_t, Value_t, Geometry_t>::sanity_check(Key_t _high_key, bool first){
     for(int i=0; i<this->cnt-1; i++){
 	for(int j=i+1; j<this->cnt; j++){
-	    if(entry[i].key > entry[j].key){
+	    if(entry.key(i) > entry.key(j)){
 		std::cerr << "lnode_t::key order is not perserved!!" << std::endl;
-		std::cout << "[" << i << "].key: " << entry[i].key << "\t[" << j << "].key: " << entry[j].key << std::endl;
+		std::cout << "[" << i << "].key: " << entry.key(i) << "\t[" << j << "].key: " << entry.key(j) << std::endl;
 	    }
 	}
     }
     for(int i=0; i<this->cnt; i++){
-	if(this->sibling_ptr && (entry[i].key > this->high_key)){
-	    std::cout << i << "lnode_t:: " << "(" << entry[i].key << ") is higher than high key " << this->high_key << std::endl;
+	if(this->sibling_ptr && (entry.key(i) > this->high_key)){
+	    std::cout << i << "lnode_t:: " << "(" << entry.key(i) << ") is higher than high key " << this->high_key << std::endl;
 	}
 	if(!first){
-	    if(this->sibling_ptr && (entry[i].key < _high_key)){
-		std::cout << "lnode_t:: " << i << "(" << entry[i].key << ") is smaller than previous high key " << _high_key << std::endl;
+	    if(this->sibling_ptr && (entry.key(i) < _high_key)){
+		std::cout << "lnode_t:: " << i << "(" << entry.key(i) << ") is smaller than previous high key " << _high_key << std::endl;
 		std::cout << "--------- node_address " << this << " , current high_key " << this->high_key << std::endl;
 	    }
 	}
     }
     if(this->sibling_ptr != nullptr)
-	(static_cast<lnode_t<Key_t, Value_t>*>(this->sibling_ptr))->sanity_check(this->high_key, false);
+	(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr))->sanity_check(this->high_key, false);
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::get_cnt(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::get_cnt(){
     return this->cnt;
 }
 
-template <typename Key_t, typename Value_t>
-double lnode_btree_t<Key_t, Value_t>::utilization(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double lnode_btree_t<Key_t, Value_t, Geometry_t>::utilization(){
     return (double)this->cnt / cardinality;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::lowerbound_linear(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::lowerbound_linear(Key_t key){
     for(int i=0; i<this->cnt; i++){
-	if(key <= entry[i].key)
+	if(key <= entry.key(i))
 	    return i;
     }
     return this->cnt;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::lowerbound_binary(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::lowerbound_binary(Key_t key){
     int lower = 0;
     int upper = this->cnt;
     do{
 	int mid = ((upper - lower) / 2) + lower;
-	if(key < entry[mid].key)
+	if(key < entry.key(mid))
 	    upper = mid;
-	else if(key > entry[mid].key)
+	else if(key > entry.key(mid))
 	    lower = mid + 1;
 	else
 	    return mid;
@@ -230,62 +348,64 @@ int lnode_btree_t<Key_t, Value_t>::lowerbound_binary(Key_t key){
 }
 
 
-template <typename Key_t, typename Value_t>
-bool lnode_btree_t<Key_t, Value_t>::update_linear(Key_t key, uint64_t value){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::update_linear(Key_t key, uint64_t value){
     for(int i=0; i<this->cnt; i++){
-	if(key == entry[i].key){
-	    entry[i].value = value;
+	if(key == entry.key(i)){
+	    entry.value(i) = value;
 	    return true;
 	}
     }
     return false;
 }
 
-template <typename Key_t, typename Value_t>
-Value_t lnode_btree_t<Key_t, Value_t>::find_linear(Key_t key){
-    for(int i=0; i<this->cnt; i++){
-	if(key == entry[i].key){
-	    auto ret = entry[i].value;
-	    return ret;
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::find_linear(Key_t key, Value_t& value, int num){
+    for(int i=0; i<num; i++){
+	if(key == entry.key(i)){
+	    value = entry.value(i);
+	    return true;
 	}
     }
-    return 0;
+    return false;
 }
 
-template <typename Key_t, typename Value_t>
-Value_t lnode_btree_t<Key_t, Value_t>::find_binary(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_btree_t<Key_t, Value_t, Geometry_t>::find_binary(Key_t key, Value_t& value, int num){
     int lower = 0;
-    int upper = this->cnt;
+    int upper = num;
     do{
 	int mid = ((upper - lower) / 2) + lower;
-	if(key < entry[mid].key)
+	if(key < entry.key(mid))
 	    upper = mid;
-	else if(key > entry[mid].key)
+	else if(key > entry.key(mid))
 	    lower = mid+1;
-	else
-	    return entry[mid].value;
+	else{
+	    value = entry.value(mid);
+	    return true;
+	}
     }while(lower < upper);
-    return 0;
+    return false;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::find_pos_linear(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::find_pos_linear(Key_t key){
     for(int i=0; i<this->cnt; i++){
-	if(key == entry[i].key)
+	if(key == entry.key(i))
 	    return i;
     }
     return -1;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_btree_t<Key_t, Value_t>::find_pos_binary(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_btree_t<Key_t, Value_t, Geometry_t>::find_pos_binary(Key_t key){
     int lower = 0;
     int upper = this->cnt;
     do{
 	int mid = ((upper - lower) / 2) + lower;
-	if(key < entry[mid].key)
+	if(key < entry.key(mid))
 	    upper = mid;
-	else if(key > entry[mid].key)
+	else if(key > entry.key(mid))
 	    lower = mid+1;
 	else
 	    return mid;
@@ -293,5 +413,11 @@ int lnode_btree_t<Key_t, Value_t>::find_pos_binary(Key_t key){
     return lower;
 }
 
-template class lnode_btree_t<key64_t, value64_t>;
+template class lnode_btree_t<key64_t, value64_t, default_geometry_t>;
+template class lnode_btree_t<key64_t, value64_t, leaf_64k_geometry_t>;
+template class lnode_btree_t<key64_t, value64_t, leaf_1m_geometry_t>;
+template class lnode_btree_t<key64_t, value64_t, page_1k_geometry_t>;
+template class lnode_btree_t<key64_t, value64_t, slot_8_geometry_t>;
+
+template class lnode_btree_t<string_key_t, value64_t, default_geometry_t>;
 }
@@ -0,0 +1,372 @@
+#include "lnode.h"
+
+namespace BLINK_HASH{
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_delta_t<Key_t, Value_t, Geometry_t>::write_unlock(){
+    (static_cast<node_t*>(this))->write_unlock();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline Key_t lnode_delta_t<Key_t, Value_t, Geometry_t>::key_at(int i, int _width){
+    auto d = delta_area(_width);
+    switch(_width){
+	case 2:
+	    return base + reinterpret_cast<uint16_t*>(d)[i];
+	case 4:
+	    return base + reinterpret_cast<uint32_t*>(d)[i];
+	default:
+	    return base + reinterpret_cast<uint64_t*>(d)[i];
+    }
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_delta_t<Key_t, Value_t, Geometry_t>::set_key(int i, Key_t key){
+    auto d = delta_area(width);
+    switch(width){
+	case 2:
+	    reinterpret_cast<uint16_t*>(d)[i] = key - base;
+	    return;
+	case 4:
+	    reinterpret_cast<uint32_t*>(d)[i] = key - base;
+	    return;
+	default:
+	    reinterpret_cast<uint64_t*>(d)[i] = key - base;
+	    return;
+    }
+}
+
+// keys below base sort first, keys beyond the width sort last, the rest are compared as deltas
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::lowerbound(Key_t key, int cnt, int _width){
+    if(cnt == 0 || key <= base)
+	return 0;
+    uint64_t delta = key - base;
+    auto d = delta_area(_width);
+    switch(_width){
+	case 2:
+	    if(delta > UINT16_MAX)
+		return cnt;
+	    return count_less(reinterpret_cast<const uint16_t*>(d), cnt, (uint16_t)delta);
+	case 4:
+	    if(delta > UINT32_MAX)
+		return cnt;
+	    return count_less(reinterpret_cast<const uint32_t*>(d), cnt, (uint32_t)delta);
+	default:
+	    return count_less(reinterpret_cast<const uint64_t*>(d), cnt, delta);
+    }
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::find_lowerbound(Key_t key){
+    return lowerbound(key, this->cnt, width);
+}
+
+// the node is read without a lock, so width and cnt are checked against each other before use
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_delta_t<Key_t, Value_t, Geometry_t>::find(Key_t key, Value_t& value){
+    int _width = width;
+    int cnt = this->cnt;
+    if((_width != 2 && _width != 4 && _width != 8) || cnt > capacity(_width))
+	return false;
+
+    int pos = lowerbound(key, cnt, _width);
+    if(pos < cnt && key_at(pos, _width) == key){
+	value = values()[pos];
+	return true;
+    }
+    return false;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::prefetch(Key_t key){
+    __builtin_prefetch(area + area_size/2);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::encode(const entry_t<Key_t, Value_t>* buf, int num){
+    this->cnt = num;
+    if(num == 0)
+	return;
+    base = buf[0].key;
+    width = width_for(buf[0].key, buf[num-1].key);
+    auto v = values();
+    for(int i=0; i<num; i++){
+	v[i] = buf[i].value;
+	set_key(i, buf[i].key);
+    }
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::decode(entry_t<Key_t, Value_t>* buf){
+    auto v = values();
+    for(int i=0; i<this->cnt; i++){
+	buf[i].key = key_at(i, width);
+	buf[i].value = v[i];
+    }
+}
+
+// shifts in place if the key fits the current encoding, otherwise re-encodes with the width the new range needs
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_delta_t<Key_t, Value_t, Geometry_t>::insert_locked(Key_t key, Value_t value){
+    int cnt = this->cnt;
+    if(cnt == 0){
+	entry_t<Key_t, Value_t> e{key, value};
+	encode(&e, 1);
+	return true;
+    }
+
+    auto low = (key < base) ? key : base;
+    auto last = key_at(cnt-1, width);
+    auto high = (last < key) ? key : last;
+    int _width = width_for(low, high);
+    if((_width == (int)width) && (base <= key)){
+	if(cnt == capacity(width))
+	    return false;
+	int pos = lowerbound(key, cnt, width);
+	auto v = values();
+	auto d = delta_area(width);
+	memmove(&v[pos+1], &v[pos], sizeof(Value_t)*(cnt-pos));
+	memmove(d + (pos+1)*width, d + pos*width, width*(cnt-pos));
+	v[pos] = value;
+	set_key(pos, key);
+	this->cnt++;
+	return true;
+    }
+
+    if(cnt + 1 > capacity(_width))
+	return false;
+    entry_t<Key_t, Value_t> buf[cnt+1];
+    decode(buf);
+    int pos = cnt;
+    while(pos > 0 && key < buf[pos-1].key){
+	buf[pos] = buf[pos-1];
+	pos--;
+    }
+    buf[pos].key = key;
+    buf[pos].value = value;
+    encode(buf, cnt+1);
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::insert(Key_t key, Value_t value, uint64_t version){
+    bool need_restart = false;
+    this->try_upgrade_writelock(version, need_restart);
+    if(need_restart)
+	return -1;
+
+    if(insert_locked(key, value)){
+	write_unlock();
+	return 0;
+    }
+    return 1; // need split
+}
+
+// keys in buf are sorted and all belong to this leaf
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version){
+    bool need_restart = false;
+    this->try_upgrade_writelock(version, need_restart);
+    if(need_restart)
+	return -1;
+
+    for(; inserted<num; inserted++){
+	if(!insert_locked(buf[inserted].key, buf[inserted].value))
+	    break;
+    }
+    write_unlock();
+
+    if(inserted < num)
+	return 1; // need split
+    return 0;
+}
+
+/* either half fits in the 8-byte width, since a leaf holds fewer than twice as many 2-byte deltas as 8-byte ones */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+lnode_delta_t<Key_t, Value_t, Geometry_t>* lnode_delta_t<Key_t, Value_t, Geometry_t>::split(Key_t& split_key, Key_t key, Value_t value){
+    static_assert(capacity(2) + 1 <= 2 * capacity(8), "half of a full leaf must fit any width");
+    int num = this->cnt + 1;
+    entry_t<Key_t, Value_t> buf[num];
+    decode(buf);
+    int pos = num - 1;
+    while(pos > 0 && key < buf[pos-1].key){
+	buf[pos] = buf[pos-1];
+	pos--;
+    }
+    buf[pos].key = key;
+    buf[pos].value = value;
+
+    int half = num/2;
+    split_key = buf[half-1].key;
+
+    auto sibling = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
+    auto new_leaf = new lnode_delta_t<Key_t, Value_t, Geometry_t>(this->sibling_ptr, this->level);
+    new_leaf->high_key = this->high_key;
+    new_leaf->encode(&buf[half], num - half);
+
+    this->sibling_ptr = static_cast<node_t*>(new_leaf);
+    this->high_key = split_key;
+    encode(buf, half);
+
+    if(sibling){
+	if(sibling->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(sibling))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(new_leaf);
+    }
+
+    return new_leaf;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_delta_t<Key_t, Value_t, Geometry_t>::merge(lnode_delta_t<Key_t, Value_t, Geometry_t>* right){
+    int num = this->cnt + right->cnt;
+    entry_t<Key_t, Value_t> buf[num];
+    decode(buf);
+    right->decode(&buf[this->cnt]);
+    if(num > fill_size(width_for(buf[0].key, buf[num-1].key)))
+	return false;
+    encode(buf, num);
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_delta_t<Key_t, Value_t, Geometry_t>::rebalance(lnode_delta_t<Key_t, Value_t, Geometry_t>* right){
+    int num = this->cnt + right->cnt;
+    entry_t<Key_t, Value_t> buf[num];
+    decode(buf);
+    right->decode(&buf[this->cnt]);
+    int half = num/2;
+    if(half > capacity(width_for(buf[0].key, buf[half-1].key)) || (num - half) > capacity(width_for(buf[half].key, buf[num-1].key)))
+	return false;
+    encode(buf, half);
+    right->encode(&buf[half], num - half);
+    this->high_key = buf[half-1].key;
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::remove(Key_t key, uint64_t version){
+    bool need_restart = false;
+    this->try_upgrade_writelock(version, need_restart);
+    if(need_restart)
+	return -1;
+
+    int cnt = this->cnt;
+    int pos = lowerbound(key, cnt, width);
+    if(pos == cnt || key_at(pos, width) != key){
+	write_unlock();
+	return 1;
+    }
+    auto v = values();
+    auto d = delta_area(width);
+    memmove(&v[pos], &v[pos+1], sizeof(Value_t)*(cnt-pos-1));
+    memmove(d + pos*width, d + (pos+1)*width, width*(cnt-pos-1));
+    this->cnt--;
+    write_unlock();
+    return 0;
+}
+
+// the keys left still fit the encoding, so the tail shifts down as in remove
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::remove_range(Key_t lo, Key_t hi){
+    int cnt = this->cnt;
+    int from = lowerbound(lo, cnt, width);
+    int to = from;
+    while((to < cnt) && (key_at(to, width) <= hi))
+	to++;
+    auto v = values();
+    auto d = delta_area(width);
+    memmove(&v[from], &v[to], sizeof(Value_t)*(cnt-to));
+    memmove(d + from*width, d + to*width, width*(cnt-to));
+    this->cnt -= to - from;
+    return to - from;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::update(Key_t key, Value_t value, uint64_t version){
+    bool need_restart = false;
+    this->try_upgrade_writelock(version, need_restart);
+    if(need_restart)
+	return -1;
+
+    int pos = lowerbound(key, this->cnt, width);
+    if(pos == this->cnt || key_at(pos, width) != key){
+	write_unlock();
+	return 1;
+    }
+    values()[pos] = value;
+    write_unlock();
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::range_lookup(Key_t key, Value_t* buf, int count, int range, bool continued){
+    auto _count = count;
+    auto v = values();
+    int cnt = this->cnt;
+    if(cnt > capacity(2))
+	return _count;
+    int pos = continued ? 0 : lowerbound(key, cnt, width) + 1;
+    for(int i=pos; i<cnt; i++){
+	buf[_count++] = v[i];
+	if(_count == range) return _count;
+    }
+    return _count;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::print(){
+    std::cout << "base: " << base << ", width: " << width << "\n";
+    for(int i=0; i<this->cnt; i++)
+	std::cout << "[" << i << "]" << key_at(i, width) << " ";
+    std::cout << "  high_key: " << this->high_key << "\n\n";
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::sanity_check(Key_t _high_key, bool first){
+    for(int i=0; i<this->cnt; i++){
+	auto key = key_at(i, width);
+	if(i > 0 && key_at(i-1, width) > key){
+	    std::cerr << "lnode_delta_t::key order is not perserved!!" << std::endl;
+	    std::cout << "[" << i-1 << "].key: " << key_at(i-1, width) << "\t[" << i << "].key: " << key << std::endl;
+	}
+	if(this->sibling_ptr && (key > this->high_key))
+	    std::cout << i << "lnode_delta_t:: " << "(" << key << ") is higher than high key " << this->high_key << std::endl;
+	if(!first && this->sibling_ptr && (key < _high_key)){
+	    std::cout << "lnode_delta_t:: " << i << "(" << key << ") is smaller than previous high key " << _high_key << std::endl;
+	    std::cout << "--------- node_address " << this << " , current high_key " << this->high_key << std::endl;
+	}
+    }
+    if(this->sibling_ptr != nullptr)
+	(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr))->sanity_check(this->high_key, false);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::get_cnt(){
+    return this->cnt;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_delta_t<Key_t, Value_t, Geometry_t>::get_width(){
+    return width;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double lnode_delta_t<Key_t, Value_t, Geometry_t>::utilization(){
+    return (double)this->cnt / capacity(width);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_delta_t<Key_t, Value_t, Geometry_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied){
+    meta += sizeof(base) + sizeof(width);
+    auto occupied = (width + sizeof(Value_t)) * this->cnt;
+    key_data_occupied += occupied;
+    key_data_unoccupied += area_size - occupied;
+}
+
+template class lnode_delta_t<key64_t, value64_t, default_geometry_t>;
+template class lnode_delta_t<key64_t, value64_t, leaf_64k_geometry_t>;
+template class lnode_delta_t<key64_t, value64_t, leaf_1m_geometry_t>;
+template class lnode_delta_t<key64_t, value64_t, page_1k_geometry_t>;
+template class lnode_delta_t<key64_t, value64_t, slot_8_geometry_t>;
+}
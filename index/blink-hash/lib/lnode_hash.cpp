@@ -4,8 +4,8 @@
 namespace BLINK_HASH{
 bool print_flag = false;
 
-template <typename Key_t, typename Value_t>
-inline bool lnode_hash_t<Key_t, Value_t>::try_splitlock(uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline bool lnode_hash_t<Key_t, Value_t, Geometry_t>::try_splitlock(uint64_t version){
     bool need_restart = false;
     (static_cast<node_t*>(this))->try_upgrade_writelock(version, need_restart);
     if(need_restart) return false;
@@ -16,11 +16,26 @@ inline bool lnode_hash_t<Key_t, Value_t>::try_splitlock(uint64_t version){
     return true;
 }
 
-template <typename Key_t, typename Value_t>
-inline bool lnode_hash_t<Key_t, Value_t>::try_convertlock(uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline bool lnode_hash_t<Key_t, Value_t, Geometry_t>::lock_bucket(int loc, uint64_t version){
+    bool need_restart = false;
+    while(!bucket[loc].try_lock()){
+	auto _version = (static_cast<node_t*>(this))->get_version(need_restart);
+	if(need_restart || (version != _version)){ // being split or converted, or already replaced
+	    conflict(RESTART_VERSION, this, &this->lock, _version);
+	    return false;
+	}
+	_mm_pause();
+    }
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline bool lnode_hash_t<Key_t, Value_t, Geometry_t>::try_convertlock(uint64_t version){
     bool need_restart = false;
     (static_cast<node_t*>(this))->try_upgrade_writelock(version, need_restart);
     if(need_restart) return false;
+    converting = true;
     for(int i=0; i<cardinality; i++){
 	while(!bucket[i].try_lock())
 	    _mm_pause();
@@ -28,50 +43,51 @@ inline bool lnode_hash_t<Key_t, Value_t>::try_convertlock(uint64_t version){
     return true;
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::split_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::split_unlock(){
     (static_cast<node_t*>(this))->write_unlock();
     for(int i=0; i<cardinality; i++)
 	bucket[i].unlock();
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::split_unlock_obsolete(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::split_unlock_obsolete(){
     (static_cast<node_t*>(this))->write_unlock_obsolete();
     for(int i=0; i<cardinality; i++)
 	bucket[i].unlock();
 }
 
-template <typename Key_t, typename Value_t>
-inline bool lnode_hash_t<Key_t, Value_t>::try_writelock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline bool lnode_hash_t<Key_t, Value_t, Geometry_t>::try_writelock(){
     return (static_cast<node_t*>(this))->try_writelock();
 }
 
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::write_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::write_unlock(){
     (static_cast<node_t*>(this))->write_unlock();
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::convert_unlock(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::convert_unlock(){
+    converting = false;
     (static_cast<node_t*>(this))->write_unlock();
     for(int i=0; i<cardinality; i++)
 	bucket[i].unlock();
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::convert_unlock_obsolete(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::convert_unlock_obsolete(){
     (static_cast<node_t*>(this))->write_unlock_obsolete();
 }
 
-template <typename Key_t, typename Value_t>
-inline uint8_t lnode_hash_t<Key_t, Value_t>::_hash(size_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline uint8_t lnode_hash_t<Key_t, Value_t, Geometry_t>::_hash(size_t key){
     return (uint8_t)(key % 256);
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_hash_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::insert(Key_t key, Value_t value, uint64_t version){
     bool need_restart = false;
 #ifdef FINGERPRINT
     #ifdef AVX_256
@@ -83,24 +99,28 @@ int lnode_hash_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t vers
     #endif
 #endif
 
-    for(int k=0; k<HASH_FUNCS_NUM; k++){
-	auto hash_key = h(&key, sizeof(Key_t), k);
+    for(int k=0; k<hash_funcs_num; k++){
+	auto hash_key = hasher_t<Key_t>::hash(key, k);
 	#ifdef FINGERPRINT
 	uint8_t fingerprint = _hash(hash_key) | 1;
 	#endif
-	for(int j=0; j<NUM_SLOT; j++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (hash_key + j) % cardinality;
-	    if(!bucket[loc].try_lock())
+	    if(!lock_bucket(loc, version)){
+		help_split();
 		return -1;
+	    }
 
 	    auto _version = (static_cast<node_t*>(this))->get_version(need_restart);
 	    if(need_restart || (version != _version)){
+		conflict(RESTART_VERSION, this, &this->lock, _version);
 		bucket[loc].unlock();
+		help_split();
 		return -1;
 	    }
 
 	    #ifdef LINKED
-	    if(bucket[loc].state != bucket_t<Key_t, Value_t>::STABLE){
+	    if(bucket[loc].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 		if(!stabilize_bucket(loc)){
 		    bucket[loc].unlock();
 		    return -1;
@@ -127,9 +147,22 @@ int lnode_hash_t<Key_t, Value_t>::insert(Key_t key, Value_t value, uint64_t vers
 }
 
 
-template <typename Key_t, typename Value_t>
-lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_key, Key_t key, Value_t value, uint64_t version){
-    auto new_right = new lnode_hash_t<Key_t, Value_t>(this->sibling_ptr, 0, this->level);
+// keys in buf all belong to this leaf; each key still takes its own bucket lock,
+// but the traversal and node version are shared by the whole batch
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::insert_batch(entry_t<Key_t, Value_t>* buf, int num, int& inserted, uint64_t version){
+    for(; inserted<num; inserted++){
+	auto ret = insert(buf[inserted].key, buf[inserted].value, version);
+	if(ret != 0)
+	    return ret;
+    }
+    return 0;
+}
+
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+lnode_hash_t<Key_t, Value_t, Geometry_t>* lnode_hash_t<Key_t, Value_t, Geometry_t>::split(Key_t& split_key, Key_t key, Value_t value, uint64_t version){
+    auto new_right = new lnode_hash_t<Key_t, Value_t, Geometry_t>(this->sibling_ptr, 0, this->level);
     new_right->high_key = this->high_key;
     new_right->left_sibling_ptr = this;
 
@@ -138,9 +171,9 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
 	uint64_t fingerprint;
     };
 
-    target_t target[HASH_FUNCS_NUM];
-    for(int k=0; k<HASH_FUNCS_NUM; k++){
-	auto hash_key = h(&key, (size_t)sizeof(Key_t), k);
+    target_t target[hash_funcs_num];
+    for(int k=0; k<hash_funcs_num; k++){
+	auto hash_key = hasher_t<Key_t>::hash(key, k);
 	target[k].loc = hash_key % cardinality;
 	target[k].fingerprint = (_hash(hash_key) | 1);
     }
@@ -240,11 +273,11 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
     #ifdef LINKED
     // set every bucket state in current node to LINKED_RIGHT
     for(int i=0; i<cardinality; i++)
-	bucket[i].state = bucket_t<Key_t, Value_t>::LINKED_RIGHT;
+	bucket[i].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_RIGHT;
 
     // insert after split
-    for(int m=0; m<HASH_FUNCS_NUM; m++){
-	for(int j=0; j<NUM_SLOT; j++){
+    for(int m=0; m<hash_funcs_num; m++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (target[m].loc + j) % cardinality;
 	    #ifdef AVX_256
 	    __m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<__m256i*>(bucket[loc].fingerprints));
@@ -298,7 +331,7 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
 		}
 	    }
 	    #elif defined AVX_128 // +simd
-	    for(int k=0; k<2; k++){
+	    for(int k=0; k<entry_num/16; k++){
 		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(bucket[loc].fingerprints + k*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -406,69 +439,30 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
     }
     #else
     // migrate keys
-    for(int j=0; j<cardinality; j++){
-        #ifdef FINGERPRINT
-	#ifdef AVX_256
-	__m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<__m256i*>(bucket[j].fingerprints));
-	__m256i cmp = _mm256_cmpeq_epi8(empty, fingerprints_);
-	uint32_t bitfield = _mm256_movemask_epi8(cmp);
-	for(int i=0; i<32; i++){
-	    auto bit = (bitfield >> i);
-	    if((bit & 0x1) == 0){
-		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
-		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
-		    new_right->bucket[j].fingerprints[i] = bucket[j].fingerprints[i];
-		    bucket[j].fingerprints[i] = 0;
-		}
-	    }
-	}
-	#elif defined AVX_128
-	for(int k=0; k<2; k++){
-	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(bucket[j].fingerprints + k*16));
-	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
-	    uint16_t bitfield = _mm_movemask_epi8(cmp);
-	    for(int i=0; i<16; i++){
-		auto bit = (bitfield >> i);
-		auto idx = k*16 + i;
-		if((bit & 0x1) == 0){
-		    if(split_key < bucket[j].entry[idx].key){ // migrate key-value to new node
-			memcpy(&new_right->bucket[j].entry[idx], &bucket[j].entry[idx], sizeof(entry_t<Key_t, Value_t>));
-			new_right->bucket[j].fingerprints[idx] = bucket[j].fingerprints[idx];
-			bucket[j].fingerprints[idx] = 0;
-		    }
-		}
-	    }
-	}
-	#else
-	for(int i=0; i<entry_num; i++){
-	    if(bucket[j].fingerprints[i] != 0){
-		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
-		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
-		    new_right->bucket[j].fingerprints[i] = bucket[j].fingerprints[i];
-		    bucket[j].fingerprints[i] = 0;
-		}
-	    }
-	}
-	#endif
-	#else // baseline
-	for(int i=0; i<entry_num; i++){
-	    if(bucket[j].entry[i].key != EMPTY<Key_t>){
-		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
-		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
-		    bucket[j].entry[i].key = EMPTY<Key_t>;
-		}
-	    }
-	}
-	#endif
-    }
+    #ifdef COOP_SPLIT
+    split_job_t job;
+    job.new_right = new_right;
+    job.split_key = split_key;
+    job.next = 0;
+    job.done = 0;
+    split_job.store(&job);
+    run_split_job(&job);
+    while(job.done.load(std::memory_order_acquire) < (int)cardinality) // ranges claimed by helpers
+	_mm_pause();
+    split_job.store(nullptr);
+    while(split_helpers.load() != 0)
+	_mm_pause();
+    #else
+    migrate(new_right, split_key, 0, cardinality);
+    #endif
 
     // insert after split
     auto target_node = this;
     if(split_key < key)
 	target_node = new_right;
 
-    for(int m=0; m<HASH_FUNCS_NUM; m++){
-	for(int j=0; j<NUM_SLOT; j++){
+    for(int m=0; m<hash_funcs_num; m++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (target[m].loc + j) % cardinality;
 	    #ifdef FINGERPRINT
 	    #ifdef AVX_256
@@ -486,22 +480,32 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
 		}
 	    }
 	    #elif defined AVX_128
-	    for(int k=0; k<2; k++){
-		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(target_node->bucket[loc].fingerprints));
+	    for(int k=0; k<entry_num/16; k++){
+		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(target_node->bucket[loc].fingerprints + k*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
 		for(int i=0; i<16; i++){
 		    auto bit = (bitfield >> i);
 		    auto idx = k*16 + i;
 		    if((bit & 0x1) == 1){
-			target_node->bucket[loc].fingerprints[i] = target[m].fingerprint;
-			target_node->bucket[loc].entry[i].key = key;
-			target_node->bucket[loc].entry[i].value = value;
+			target_node->bucket[loc].fingerprints[idx] = target[m].fingerprint;
+			target_node->bucket[loc].entry[idx].key = key;
+			target_node->bucket[loc].entry[idx].value = value;
 			need_insert = false;
 			goto PROCEED;
 		    }
 		}
 	    }
+	    #elif defined AVX_512
+	    uint32_t bitfield = target_node->bucket[loc].probe(0, 0) >> 32;
+	    if(bitfield){
+		auto i = __builtin_ctz(bitfield);
+		target_node->bucket[loc].fingerprints[i] = target[m].fingerprint;
+		target_node->bucket[loc].entry[i].key = key;
+		target_node->bucket[loc].entry[i].value = value;
+		need_insert = false;
+		goto PROCEED;
+	    }
 	    #else
 	    for(int i=0; i<entry_num; i++){
 		if(target_node->bucket[loc].fingerprints[i] == 0){
@@ -528,11 +532,11 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
     #endif
 
     PROCEED:
-    auto sibling = static_cast<lnode_t<Key_t, Value_t>*>(this->sibling_ptr);
+    auto sibling = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
     this->sibling_ptr = new_right;
     if(sibling){
-	if(sibling->type == lnode_t<Key_t, Value_t>::HASH_NODE)
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(sibling))->left_sibling_ptr = new_right;
+	if(sibling->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(sibling))->left_sibling_ptr = new_right;
     }
     // update current node's right sibling pointer
     if(need_insert){
@@ -549,11 +553,113 @@ lnode_hash_t<Key_t, Value_t>* lnode_hash_t<Key_t, Value_t>::split(Key_t& split_k
     return new_right;
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_hash_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t vstart){
+/* moves the entries above split_key in buckets [from, to) to new_right, with every bucket already locked by the splitter */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::migrate(lnode_hash_t<Key_t, Value_t, Geometry_t>* new_right, Key_t split_key, int from, int to){
+#ifdef FINGERPRINT
+    #ifdef AVX_256
+    __m256i empty = _mm256_setzero_si256();
+    #elif defined AVX_128
+    __m128i empty = _mm_setzero_si128();
+    #endif
+#endif
+    for(int j=from; j<to; j++){
+        #ifdef FINGERPRINT
+	#ifdef AVX_256
+	__m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<__m256i*>(bucket[j].fingerprints));
+	__m256i cmp = _mm256_cmpeq_epi8(empty, fingerprints_);
+	uint32_t bitfield = _mm256_movemask_epi8(cmp);
+	for(int i=0; i<32; i++){
+	    auto bit = (bitfield >> i);
+	    if((bit & 0x1) == 0){
+		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
+		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
+		    new_right->bucket[j].fingerprints[i] = bucket[j].fingerprints[i];
+		    bucket[j].fingerprints[i] = 0;
+		}
+	    }
+	}
+	#elif defined AVX_128
+	for(int k=0; k<entry_num/16; k++){
+	    __m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(bucket[j].fingerprints + k*16));
+	    __m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
+	    uint16_t bitfield = _mm_movemask_epi8(cmp);
+	    for(int i=0; i<16; i++){
+		auto bit = (bitfield >> i);
+		auto idx = k*16 + i;
+		if((bit & 0x1) == 0){
+		    if(split_key < bucket[j].entry[idx].key){ // migrate key-value to new node
+			memcpy(&new_right->bucket[j].entry[idx], &bucket[j].entry[idx], sizeof(entry_t<Key_t, Value_t>));
+			new_right->bucket[j].fingerprints[idx] = bucket[j].fingerprints[idx];
+			bucket[j].fingerprints[idx] = 0;
+		    }
+		}
+	    }
+	}
+	#elif defined AVX_512
+	for(uint32_t bitfield = ~(uint32_t)(bucket[j].probe(0, 0) >> 32); bitfield; bitfield &= bitfield - 1){
+	    auto i = __builtin_ctz(bitfield);
+	    if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
+		memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
+		new_right->bucket[j].fingerprints[i] = bucket[j].fingerprints[i];
+		bucket[j].fingerprints[i] = 0;
+	    }
+	}
+	#else
+	for(int i=0; i<entry_num; i++){
+	    if(bucket[j].fingerprints[i] != 0){
+		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
+		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
+		    new_right->bucket[j].fingerprints[i] = bucket[j].fingerprints[i];
+		    bucket[j].fingerprints[i] = 0;
+		}
+	    }
+	}
+	#endif
+	#else // baseline
+	for(int i=0; i<entry_num; i++){
+	    if(bucket[j].entry[i].key != EMPTY<Key_t>){
+		if(split_key < bucket[j].entry[i].key){ // migrate key-value to new node
+		    memcpy(&new_right->bucket[j].entry[i], &bucket[j].entry[i], sizeof(entry_t<Key_t, Value_t>));
+		    bucket[j].entry[i].key = EMPTY<Key_t>;
+		}
+	    }
+	}
+	#endif
+    }
+}
+
+#ifdef COOP_SPLIT
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::run_split_job(split_job_t* job){
+    int from;
+    while((from = job->next.fetch_add(split_chunk)) < (int)cardinality){
+	int to = std::min(from + split_chunk, (int)cardinality);
+	migrate(job->new_right, job->split_key, from, to);
+	job->done.fetch_add(to - from, std::memory_order_release);
+    }
+}
+#endif
+
+/* called by writers that find this node locked, they migrate bucket ranges of an ongoing split instead of just spinning */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::help_split(){
+    #ifdef COOP_SPLIT
+    if(split_job.load(std::memory_order_relaxed) == nullptr)
+	return;
+    split_helpers.fetch_add(1);
+    auto job = split_job.load(); // the splitter waits for split_helpers to drain before its job goes out of scope
+    if(job)
+	run_split_job(job);
+    split_helpers.fetch_sub(1);
+    #endif
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::update(Key_t key, Value_t value, uint64_t vstart){
     bool need_restart = false;
-    for(int k=0; k<HASH_FUNCS_NUM; k++){
-	auto hash_key = h(&key, sizeof(Key_t), k);
+    for(int k=0; k<hash_funcs_num; k++){
+	auto hash_key = hasher_t<Key_t>::hash(key, k);
     #ifdef FINGERPRINT
 	#ifdef AVX_256
 	__m256i fingerprint = _mm256_set1_epi8(_hash(hash_key) | 1);
@@ -564,18 +670,19 @@ int lnode_hash_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t vsta
 	#endif
     #endif
 
-	for(int j=0; j<NUM_SLOT; j++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (hash_key + j) % cardinality;
-	    if(!bucket[loc].try_lock())
+	    if(!lock_bucket(loc, vstart))
 		return -1;
 
 	    auto vend = (static_cast<node_t*>(this))->get_version(need_restart);
 	    if(need_restart || (vstart != vend)){
+		conflict(RESTART_VERSION, this, &this->lock, vend);
 		bucket[loc].unlock();
 		return -1;
 	    }
 	    #ifdef LINKED
-	    if(bucket[loc].state != bucket_t<Key_t, Value_t>::STABLE){
+	    if(bucket[loc].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 		auto ret = stabilize_bucket(loc);
 		if(!ret){
 		    bucket[loc].unlock();
@@ -602,11 +709,20 @@ int lnode_hash_t<Key_t, Value_t>::update(Key_t key, Value_t value, uint64_t vsta
     return 1; // key not found
 }
 
-template <typename Key_t, typename Value_t>
-int lnode_hash_t<Key_t, Value_t>::remove(Key_t key, uint64_t vstart){
+// every bucket is locked and stabilized by the caller
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::remove_range(Key_t lo, Key_t hi){
+    int num = 0;
+    for(int j=0; j<cardinality; j++)
+	num += bucket[j].remove_range(lo, hi);
+    return num;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::remove(Key_t key, uint64_t vstart){
     bool need_restart = false;
-    for(int k=0; k<HASH_FUNCS_NUM; k++){
-	auto hash_key = h(&key, sizeof(Key_t), k);
+    for(int k=0; k<hash_funcs_num; k++){
+	auto hash_key = hasher_t<Key_t>::hash(key, k);
     #ifdef FINGERPRINT
 	#ifdef AVX_256
 	__m256i fingerprint = _mm256_set1_epi8(_hash(hash_key) | 1);
@@ -617,18 +733,19 @@ int lnode_hash_t<Key_t, Value_t>::remove(Key_t key, uint64_t vstart){
 	#endif
     #endif
 
-	for(int j=0; j<NUM_SLOT; j++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (hash_key + j) % cardinality;
-	    if(!bucket[loc].try_lock())
+	    if(!lock_bucket(loc, vstart))
 		return -1;
 
 	    auto vend = (static_cast<node_t*>(this))->get_version(need_restart);
 	    if(need_restart || (vstart != vend)){
+		conflict(RESTART_VERSION, this, &this->lock, vend);
 		bucket[loc].unlock();
 		return -1;
 	    }
 	    #ifdef LINKED
-	    if(bucket[loc].state != bucket_t<Key_t, Value_t>::STABLE){
+	    if(bucket[loc].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 		auto ret = stabilize_bucket(loc);
 		if(!ret){
 		    bucket[loc].unlock();
@@ -656,10 +773,10 @@ int lnode_hash_t<Key_t, Value_t>::remove(Key_t key, uint64_t vstart){
 }
 
 
-template <typename Key_t, typename Value_t>
-Value_t lnode_hash_t<Key_t, Value_t>::find(Key_t key, bool& need_restart){
-    for(int k=0; k<HASH_FUNCS_NUM; k++){
-	auto hash_key = h(&key, sizeof(Key_t), k);
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_hash_t<Key_t, Value_t, Geometry_t>::find(Key_t key, Value_t& value, bool& need_restart){
+    for(int k=0; k<hash_funcs_num; k++){
+	auto hash_key = hasher_t<Key_t>::hash(key, k);
     #ifdef FINGERPRINT
 	#ifdef AVX_256
 	__m256i fingerprint = _mm256_set1_epi8(_hash(hash_key) | 1);
@@ -670,24 +787,24 @@ Value_t lnode_hash_t<Key_t, Value_t>::find(Key_t key, bool& need_restart){
 	#endif
     #endif
 
-	for(int j=0; j<NUM_SLOT; j++){
+	for(int j=0; j<num_slot; j++){
 	    auto loc = (hash_key + j) % cardinality;
 
 	    auto bucket_vstart = bucket[loc].get_version(need_restart);
 	    if(need_restart)
-		return 0;
+		return false;
 
 	    #ifdef LINKED
-	    if(bucket[loc].state != bucket_t<Key_t, Value_t>::STABLE){
+	    if(bucket[loc].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 		if(!bucket[loc].upgrade_lock(bucket_vstart)){
 		    need_restart = true;
-		    return 0;
+		    return false;
 		}
 
 		if(!stabilize_bucket(loc)){
 		    bucket[loc].unlock();
 		    need_restart = true;
-		    return 0;
+		    return false;
 		}
 
 		bucket[loc].unlock();
@@ -695,40 +812,46 @@ Value_t lnode_hash_t<Key_t, Value_t>::find(Key_t key, bool& need_restart){
 	    }
 	    #endif
 
-	    Value_t ret;
 	    #ifdef FINGERPRINT
-	    if(bucket[loc].find(key, ret, fingerprint)){ // found
+	    if(bucket[loc].find(key, value, fingerprint)){ // found
 		auto bucket_vend = bucket[loc].get_version(need_restart);
 		if(need_restart || (bucket_vstart != bucket_vend)){
 		    need_restart = true;
-		    return 0;
+		    return false;
 		}
-		return ret;
+		return true;
 	    }
 	    #else
-	    if(bucket[loc].find(key, ret)){ // found
+	    if(bucket[loc].find(key, value)){ // found
 		auto bucket_vend = bucket[loc].get_version(need_restart);
 		if(need_restart || (bucket_vstart != bucket_vend)){
 		    need_restart = true;
-		    return 0;
+		    return false;
 		}
-		return ret;
+		return true;
 	    }
 	    #endif
 
 	    auto bucket_vend = bucket[loc].get_version(need_restart);
 	    if(need_restart || (bucket_vstart != bucket_vend)){
 		need_restart = true;
-		return 0;
+		return false;
 	    }
 	}
     }
-    return 0;
+    return false;
 }
 
+// touches the first candidate bucket of the first hash function, where most keys live
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::prefetch(Key_t key){
+    auto hash_key = hasher_t<Key_t>::hash(key, 0);
+    __builtin_prefetch(&bucket[hash_key % cardinality]);
+}
 
-template <typename Key_t, typename Value_t>
-int lnode_hash_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int count, int range){
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::range_lookup(Key_t key, Value_t* buf, int count, int range){
     bool need_restart = false;
 
     entry_t<Key_t, Value_t> _buf[cardinality * entry_num];
@@ -750,7 +873,7 @@ int lnode_hash_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int coun
 	if(need_restart) return -1;
 
 	#ifdef LINKED
-	if(bucket[j].state != bucket_t<Key_t, Value_t>::STABLE){
+	if(bucket[j].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 	    if(!bucket[j].upgrade_lock(bucket_vstart))
 		return -1;
 
@@ -775,11 +898,18 @@ int lnode_hash_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int coun
 	    return -1;
     }
 
-    std::sort(_buf, _buf+idx, [](entry_t<Key_t, Value_t>& a, entry_t<Key_t, Value_t>& b){
-	    return a.key < b.key;
-	    });
+    auto cmp = [](const entry_t<Key_t, Value_t>& a, const entry_t<Key_t, Value_t>& b){
+	return a.key < b.key;
+    };
+
+    // only the smallest (range - count) entries are returned, select them first and sort just those
+    int need = range - _count;
+    if(need < idx){
+	std::nth_element(_buf, _buf+need, _buf+idx, cmp);
+	idx = need;
+    }
+    std::sort(_buf, _buf+idx, cmp);
 
-    bool lower_bound = true;
     for(int i=0; i<idx; i++){
 	buf[_count++] = _buf[i].value;
 	if(_count == range)
@@ -789,8 +919,8 @@ int lnode_hash_t<Key_t, Value_t>::range_lookup(Key_t key, Value_t* buf, int coun
 }
 
 // need to use structure to return output
-template <typename Key_t, typename Value_t>
-lnode_btree_t<Key_t, Value_t>** lnode_hash_t<Key_t, Value_t>::convert(int& num, uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+lnode_t<Key_t, Value_t, Geometry_t>** lnode_hash_t<Key_t, Value_t, Geometry_t>::convert(int& num, uint64_t version){
     bool need_restart = false;
     int idx = 0;
     entry_t<Key_t, Value_t> buf[cardinality * entry_num];
@@ -811,42 +941,65 @@ lnode_btree_t<Key_t, Value_t>** lnode_hash_t<Key_t, Value_t>::convert(int& num,
 	}
     }
 
-#ifdef FINGERPRINT
-    #ifdef AVX_256
-    __m256i empty = _mm256_setzero_si256();
-    #elif defined AVX_128
-    __m128i empty = _mm_setzero_si128();
-    #else
-    uint8_t empty = 0;
-    #endif
-    for(int i=0; i<cardinality; i++)
-	bucket[i].collect(buf, idx, empty);
-#else
-    for(int i=0; i<cardinality; i++)
-	bucket[i].collect(buf, idx);
-#endif
-
-    std::sort(buf, buf+idx, [](entry_t<Key_t, Value_t>& a, entry_t<Key_t, Value_t>& b){
-	    return a.key < b.key;
-	    });
-
-    size_t batch_size = FILL_SIZE<Key_t, Value_t>;
-    if(idx % batch_size == 0)
-	num = idx / batch_size;
+    idx = collect(buf);
+
+    lnode_t<Key_t, Value_t, Geometry_t>** leaf;
+    #ifdef DELTA_LEAF
+    if constexpr(key_traits_t<Key_t>::delta){
+	// each leaf takes as many keys as the delta width that packs the most of them allows
+	std::vector<int> sizes;
+	for(int from=0; from<idx; ){
+	    int best = 0;
+	    for(int width: {2, 4, 8}){
+		int n = 0;
+		int limit = std::min(lnode_delta_t<Key_t, Value_t, Geometry_t>::fill_size(width), idx - from);
+		while(n < limit && lnode_delta_t<Key_t, Value_t, Geometry_t>::width_for(buf[from].key, buf[from+n].key) <= width)
+		    n++;
+		best = std::max(best, n);
+	    }
+	    sizes.push_back(best);
+	    from += best;
+	}
+	if(sizes.empty()) // emptied by removes, still converts into one leaf
+	    sizes.push_back(0);
+	num = sizes.size();
+
+	leaf = new lnode_t<Key_t, Value_t, Geometry_t>*[num];
+	int from = 0;
+	for(int i=0; i<num; i++){
+	    auto node = new lnode_delta_t<Key_t, Value_t, Geometry_t>();
+	    node->encode(&buf[from], sizes[i]);
+	    from += sizes[i];
+	    node->high_key = from ? buf[from-1].key : this->high_key;
+	    leaf[i] = node;
+	}
+    }
     else
-	num = idx / batch_size + 1;
-
-    auto leaf = new lnode_btree_t<Key_t, Value_t>*[num];
-    for(int i=0; i<num; i++)
-	leaf[i] = new lnode_btree_t<Key_t, Value_t>();
+    #endif
+    {
+	size_t batch_size = FILL_SIZE<Key_t, Value_t, Geometry_t>;
+	if(idx % batch_size == 0)
+	    num = idx / batch_size;
+	else
+	    num = idx / batch_size + 1;
+	if(num == 0) // emptied by removes, still converts into one leaf
+	    num = 1;
+
+	leaf = new lnode_t<Key_t, Value_t, Geometry_t>*[num];
+	int from = 0;
+	for(int i=0; i<num; i++){
+	    auto node = new lnode_btree_t<Key_t, Value_t, Geometry_t>();
+	    if(from < idx)
+		node->batch_insert(buf, batch_size, from, idx);
+	    leaf[i] = node;
+	}
+    }
 
-    int from = 0;
     for(int i=0; i<num; i++){
 	if(i < num-1)
 	    leaf[i]->sibling_ptr = static_cast<node_t*>(leaf[i+1]);
 	else
 	    leaf[i]->sibling_ptr = this->sibling_ptr;
-	leaf[i]->batch_insert(buf, batch_size, from, idx);
     }
     leaf[num-1]->high_key = this->high_key;
     (static_cast<node_t*>(leaf[0]))->writelock();
@@ -856,16 +1009,40 @@ lnode_btree_t<Key_t, Value_t>** lnode_hash_t<Key_t, Value_t>::convert(int& num,
 	(reinterpret_cast<node_t*>(left))->write_unlock();
     }
 
-    auto right = static_cast<lnode_t<Key_t, Value_t>*>(this->sibling_ptr);
+    auto right = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
     if(right){
-	if(right->type == lnode_t<Key_t, Value_t>::HASH_NODE)
-	    (static_cast<lnode_hash_t<Key_t, Value_t>*>(right))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t>*>(leaf[num-1]);
+	if(right->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(right))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf[num-1]);
     }
     return leaf;
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_hash_t<Key_t, Value_t>::print(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::collect(entry_t<Key_t, Value_t>* buf){
+    int idx = 0;
+#ifdef FINGERPRINT
+    #ifdef AVX_256
+    __m256i empty = _mm256_setzero_si256();
+    #elif defined AVX_128
+    __m128i empty = _mm_setzero_si128();
+    #else
+    uint8_t empty = 0;
+    #endif
+    for(int i=0; i<cardinality; i++)
+	bucket[i].collect(buf, idx, empty);
+#else
+    for(int i=0; i<cardinality; i++)
+	bucket[i].collect(buf, idx);
+#endif
+
+    std::sort(buf, buf+idx, [](entry_t<Key_t, Value_t>& a, entry_t<Key_t, Value_t>& b){
+	    return a.key < b.key;
+	    });
+    return idx;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::print(){
     std::cout << "left_sibling: " << left_sibling_ptr << std::endl;
     std::cout << "right_sibling: " << this->sibling_ptr << std::endl;
     std::cout << "node_high_key: " << this->high_key << std::endl;
@@ -876,19 +1053,24 @@ void lnode_hash_t<Key_t, Value_t>::print(){
     std::cout << "\n\n";
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_hash_t<Key_t, Value_t>::sanity_check(Key_t _high_key, bool first){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::sanity_check(Key_t _high_key, bool first){
     if(this->sibling_ptr != nullptr)
-	(static_cast<lnode_t<Key_t, Value_t>*>(this->sibling_ptr))->sanity_check(this->high_key, false);
+	(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr))->sanity_check(this->high_key, false);
 }
 
-template <typename Key_t, typename Value_t>
-double lnode_hash_t<Key_t, Value_t>::utilization(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double lnode_hash_t<Key_t, Value_t, Geometry_t>::utilization(){
+    return (double)count()/(cardinality*entry_num);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int lnode_hash_t<Key_t, Value_t, Geometry_t>::count(){
     int cnt = 0;
     for(int j=0; j<cardinality; j++){
 	for(int i=0; i<entry_num; i++){
 	    #ifdef FINGERPRINT
-	    if((bucket[j].fingerprints[i] && 0b1) != 0b1)
+	    if(bucket[j].fingerprints[i] != 0)
 		cnt++;
 	    #else
 	    if(bucket[j].entry[i].key != EMPTY<Key_t>)
@@ -896,11 +1078,11 @@ double lnode_hash_t<Key_t, Value_t>::utilization(){
 	    #endif
 	}
     }
-    return (double)cnt/(cardinality*entry_num);
+    return cnt;
 }
 
-template <typename Key_t, typename Value_t>
-bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_hash_t<Key_t, Value_t, Geometry_t>::stabilize_all(uint64_t version){
 #if !defined(FINGERPRINT) || !defined(LINKED)
     std::cout << __func__ << ": cannot be called if FINGERPRINT and LINKED flags are not defined" << std::endl;
     return false;
@@ -915,7 +1097,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
     #endif
 
     for(int j=0; j<cardinality; j++){
-	if(bucket[j].state != bucket_t<Key_t, Value_t>::STABLE){
+	if(bucket[j].state != bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE){
 	    if(!bucket[j].try_lock())
 		return false;
 	}
@@ -927,7 +1109,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 	    return false;
 	}
 
-	if(bucket[j].state == bucket_t<Key_t, Value_t>::LINKED_LEFT){
+	if(bucket[j].state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_LEFT){
 	    auto left = left_sibling_ptr;
 	    auto left_bucket = &left->bucket[j];
 	    if(!left_bucket->try_lock()){
@@ -950,7 +1132,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 		}
 	    }
 	    #elif defined AVX_128
-	    for(int m=0; m<2; m++){
+	    for(int m=0; m<entry_num/16; m++){
 		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(left_bucket->fingerprints + m*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -979,13 +1161,13 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 		}
 	    }
 	    #endif
-	    bucket[j].state = bucket_t<Key_t, Value_t>::STABLE;
-	    left_bucket->state = bucket_t<Key_t, Value_t>::STABLE;
+	    bucket[j].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
+	    left_bucket->state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
 	    left_bucket->unlock();
 	    bucket[j].unlock();
 	}
-	else if(bucket[j].state == bucket_t<Key_t, Value_t>::LINKED_RIGHT){
-	    auto right = static_cast<lnode_hash_t<Key_t, Value_t>*>(this->sibling_ptr);
+	else if(bucket[j].state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_RIGHT){
+	    auto right = static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
 	    auto right_bucket = &right->bucket[j];
 	    if(!right_bucket->try_lock()){
 		bucket[j].unlock();
@@ -1007,7 +1189,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 		}
 	    }
 	    #elif defined AVX_128
-	    for(int m=0; m<2; m++){
+	    for(int m=0; m<entry_num/16; m++){
 		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(bucket[j].fingerprints + m*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -1036,8 +1218,8 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 		}
 	    }
 	    #endif
-	    bucket[j].state = bucket_t<Key_t, Value_t>::STABLE;
-	    right_bucket->state = bucket_t<Key_t, Value_t>::STABLE;
+	    bucket[j].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
+	    right_bucket->state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
 	    right_bucket->unlock();
 	    bucket[j].unlock();
 	}
@@ -1049,15 +1231,15 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_all(uint64_t version){
 #endif
 }
 
-template <typename Key_t, typename Value_t>
-bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool lnode_hash_t<Key_t, Value_t, Geometry_t>::stabilize_bucket(int loc){
 #if (!defined FINGERPRINT) || (!defined LINKED)
     std::cout << __func__ << ": cannot be called if FINGERPRINT and LINKED flags are not defined" << std::endl;
     return false;
 #else
     RETRY:
     bool need_restart = false;
-    if(bucket[loc].state == bucket_t<Key_t, Value_t>::LINKED_LEFT){
+    if(bucket[loc].state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_LEFT){
 	auto left = left_sibling_ptr;
 	auto left_bucket = &left->bucket[loc];
 	auto left_vstart = (static_cast<node_t*>(left))->get_version(need_restart);
@@ -1073,7 +1255,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 	    return false;
 	}
 
-	if(left_bucket->state == bucket_t<Key_t, Value_t>::LINKED_RIGHT){
+	if(left_bucket->state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_RIGHT){
 	    #ifdef AVX_256
 	    __m256i empty = _mm256_setzero_si256();
 	    __m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<__m256i*>(left_bucket->fingerprints));
@@ -1092,7 +1274,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 	    }
 	    #elif defined AVX_128
 	    __m128i empty = _mm_setzero_si128();
-	    for(int m=0; m<2; m++){
+	    for(int m=0; m<entry_num/16; m++){
 		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(left_bucket->fingerprints + m*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -1121,8 +1303,8 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 		}
 	    }
 	    #endif
-	    bucket[loc].state = bucket_t<Key_t, Value_t>::STABLE;
-	    left_bucket->state = bucket_t<Key_t, Value_t>::STABLE;
+	    bucket[loc].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
+	    left_bucket->state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
 	    left_bucket->unlock();
 	}
 	else{
@@ -1131,8 +1313,8 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 	    return false;
 	}
     }
-    else if(bucket[loc].state == bucket_t<Key_t, Value_t>::LINKED_RIGHT){
-	auto right = static_cast<lnode_hash_t<Key_t, Value_t>*>(this->sibling_ptr);
+    else if(bucket[loc].state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_RIGHT){
+	auto right = static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(this->sibling_ptr);
 	auto right_bucket = &right->bucket[loc];
 	auto right_vstart = (static_cast<node_t*>(right))->get_version(need_restart);
 	if(need_restart)
@@ -1147,7 +1329,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 	    return false;
 	}
 
-	if(right_bucket->state == bucket_t<Key_t, Value_t>::LINKED_LEFT){
+	if(right_bucket->state == bucket_t<Key_t, Value_t, Geometry_t::entry_num>::LINKED_LEFT){
 	    #ifdef AVX_256
 	    __m256i empty = _mm256_setzero_si256();
 	    __m256i fingerprints_ = _mm256_loadu_si256(reinterpret_cast<__m256i*>(bucket[loc].fingerprints));
@@ -1166,7 +1348,7 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 	    }
 	    #elif defined AVX_128
 	    __m128i empty = _mm_setzero_si128();
-	    for(int m=0; m<2; m++){
+	    for(int m=0; m<entry_num/16; m++){
 		__m128i fingerprints_ = _mm_loadu_si128(reinterpret_cast<__m128i*>(bucket[loc].fingerprints + m*16));
 		__m128i cmp = _mm_cmpeq_epi8(empty, fingerprints_);
 		uint16_t bitfield = _mm_movemask_epi8(cmp);
@@ -1195,8 +1377,8 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 		}
 	    }
 	    #endif
-	    bucket[loc].state = bucket_t<Key_t, Value_t>::STABLE;
-	    right_bucket->state = bucket_t<Key_t, Value_t>::STABLE;
+	    bucket[loc].state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
+	    right_bucket->state = bucket_t<Key_t, Value_t, Geometry_t::entry_num>::STABLE;
 	    right_bucket->unlock();
 	}
 	else{
@@ -1209,16 +1391,16 @@ bool lnode_hash_t<Key_t, Value_t>::stabilize_bucket(int loc){
 #endif
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::swap(Key_t* a, Key_t* b){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::swap(Key_t* a, Key_t* b){
     Key_t temp;
     memcpy(&temp, a, sizeof(Key_t));
     memcpy(a, b, sizeof(Key_t));
     memcpy(b, &temp, sizeof(Key_t));
 }
 
-template <typename Key_t, typename Value_t>
-inline int lnode_hash_t<Key_t, Value_t>::partition(Key_t* keys, int left, int right){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline int lnode_hash_t<Key_t, Value_t, Geometry_t>::partition(Key_t* keys, int left, int right){
     Key_t last = keys[right];
     int i = left, j = left;
     while(j < right){
@@ -1232,16 +1414,16 @@ inline int lnode_hash_t<Key_t, Value_t>::partition(Key_t* keys, int left, int ri
     return i;
 }
 
-template <typename Key_t, typename Value_t>
-inline int lnode_hash_t<Key_t, Value_t>::random_partition(Key_t* keys, int left, int right){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline int lnode_hash_t<Key_t, Value_t, Geometry_t>::random_partition(Key_t* keys, int left, int right){
     int n = right - left + 1;
     int pivot = rand() % n;
     swap(&keys[left+pivot], &keys[right]);
     return partition(keys, left, right);
 }
 
-template <typename Key_t, typename Value_t>
-inline void lnode_hash_t<Key_t, Value_t>::median_util(Key_t* keys, int left, int right, int k, int& a, int& b){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline void lnode_hash_t<Key_t, Value_t, Geometry_t>::median_util(Key_t* keys, int left, int right, int k, int& a, int& b){
     if(left <= right){
 	int partition_idx = random_partition(keys, left, right);
 	if(partition_idx == k){
@@ -1275,8 +1457,8 @@ inline void lnode_hash_t<Key_t, Value_t>::median_util(Key_t* keys, int left, int
 #define SPLIT_POLICY (2)
 #endif
 
-template <typename Key_t, typename Value_t>
-inline int lnode_hash_t<Key_t, Value_t>::find_median(Key_t* keys, int n){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline int lnode_hash_t<Key_t, Value_t, Geometry_t>::find_median(Key_t* keys, int n){
     int ret;
     int a = -1, b = -1;
     /*
@@ -1302,13 +1484,19 @@ inline int lnode_hash_t<Key_t, Value_t>::find_median(Key_t* keys, int n){
     return ret;
 }
 
-template <typename Key_t, typename Value_t>
-void lnode_hash_t<Key_t, Value_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied){
-    structural_data_occupied += sizeof(lnode_t<Key_t, Value_t>*);
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void lnode_hash_t<Key_t, Value_t, Geometry_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied){
+    structural_data_occupied += sizeof(lnode_t<Key_t, Value_t, Geometry_t>*);
     for(int i=0; i<cardinality; i++){
 	bucket[i].footprint(meta, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied);
     }
 }
 
-template class lnode_hash_t<key64_t, value64_t>;
+template class lnode_hash_t<key64_t, value64_t, default_geometry_t>;
+template class lnode_hash_t<key64_t, value64_t, leaf_64k_geometry_t>;
+template class lnode_hash_t<key64_t, value64_t, leaf_1m_geometry_t>;
+template class lnode_hash_t<key64_t, value64_t, page_1k_geometry_t>;
+template class lnode_hash_t<key64_t, value64_t, slot_8_geometry_t>;
+
+template class lnode_hash_t<string_key_t, value64_t, default_geometry_t>;
 }
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <thread>
 #include "common.h"
+#include "backoff.h"
 
 #include <x86intrin.h>
 #include <immintrin.h>
@@ -21,8 +22,29 @@ namespace BLINK_HASH{
 #define BITS_PER_LONG 64
 #define BITOP_WORD(nr) ((nr) / BITS_PER_LONG)
 
-//#define PAGE_SIZE (1024)
-#define PAGE_SIZE (512)
+/* node geometry, the last template parameter of every node type and of btree_t
+   leaf_hash_size: bytes per hash leaf
+   page_size: bytes per inner node and per btree leaf
+   entry_num: slots per bucket
+   num_slot: buckets probed per hash function
+   hash_funcs_num: hash functions per key */
+template <size_t LeafHashSize, size_t PageSize, int EntryNum, int NumSlot, int HashFuncsNum>
+struct geometry_t{
+    static constexpr size_t leaf_hash_size = LeafHashSize;
+    static constexpr size_t page_size = PageSize;
+    static constexpr size_t leaf_btree_size = PageSize;
+    static constexpr int entry_num = EntryNum;
+    static constexpr int num_slot = NumSlot;
+    static constexpr int hash_funcs_num = HashFuncsNum;
+};
+
+using default_geometry_t = geometry_t<1024 * 256, 512, 32, 4, 2>;
+
+// pre-instantiated in the library next to the default
+using leaf_64k_geometry_t = geometry_t<1024 * 64, 512, 32, 4, 2>;
+using leaf_1m_geometry_t = geometry_t<1024 * 1024, 512, 32, 4, 2>;
+using page_1k_geometry_t = geometry_t<1024 * 256, 1024, 32, 4, 2>;
+using slot_8_geometry_t = geometry_t<1024 * 256, 512, 32, 8, 2>;
 
 #define CACHELINE_SIZE 64
 #define FILL_FACTOR (0.8)
@@ -93,6 +115,7 @@ class node_t{
 	uint64_t get_version(bool& need_restart){
 	    uint64_t version = lock.load();
 	    if(is_locked(version) || is_obsolete(version)){
+		conflict(RESTART_VERSION, this, &lock, version);
 		_mm_pause();
 		need_restart = true;
 	    }
@@ -102,6 +125,7 @@ class node_t{
 	uint64_t try_readlock(bool& need_restart){
 	    uint64_t version = lock.load();
 	    if(is_locked(version) || is_obsolete(version)){
+		conflict(RESTART_VERSION, this, &lock, version);
 		_mm_pause();
 		need_restart = true;
 	    }
@@ -119,11 +143,13 @@ class node_t{
 	bool try_writelock(){
 	    uint64_t version = lock.load();
 	    if(is_locked(version) || is_obsolete(version)){
+		conflict(RESTART_VERSION, this, &lock, version);
 		_mm_pause();
 		return false;
 	    }
 
 	    if(!lock.compare_exchange_strong(version, version + 0b10)){
+		conflict(RESTART_VERSION, this, &lock, version);
 		_mm_pause();
 		return false;
 	    }
@@ -133,11 +159,13 @@ class node_t{
 	void try_upgrade_writelock(uint64_t version, bool& need_restart){
 	    uint64_t _version = lock.load();
 	    if(version != _version){
+		conflict(RESTART_VERSION, this, &lock, _version);
 		need_restart = true;
 		return;
 	    }
 
 	    if(!lock.compare_exchange_strong(version, version + 0b10)){
+		conflict(RESTART_VERSION, this, &lock, version);
 		_mm_pause();
 		need_restart = true;
 	    }
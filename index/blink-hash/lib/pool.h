@@ -0,0 +1,160 @@
+#ifndef BLINK_HASH_POOL_H__
+#define BLINK_HASH_POOL_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <sys/mman.h>
+
+namespace BLINK_HASH{
+
+/* per size-class node pool
+   nodes are carved out of 2 MiB slabs (huge-page backed and prefaulted) and recycled through
+   a thread-local free list, which spills to and refills from a shared list in batches */
+template <typename Node_t>
+class node_pool_t{
+    public:
+	static constexpr size_t SLAB_SIZE = 2 * 1024 * 1024;
+	static constexpr size_t NODE_SIZE = (sizeof(Node_t) + 63) & ~(size_t)63;
+	static constexpr size_t NODES_PER_SLAB = SLAB_SIZE / NODE_SIZE;
+	// nodes a thread keeps for itself (a quarter of a slab, at most 64)
+	static constexpr size_t LOCAL_MAX = (SLAB_SIZE/4/NODE_SIZE == 0) ? 1 : ((SLAB_SIZE/4/NODE_SIZE > 64) ? 64 : SLAB_SIZE/4/NODE_SIZE);
+	static constexpr size_t BATCH = (LOCAL_MAX/2 == 0) ? 1 : LOCAL_MAX/2;
+
+	static_assert(NODES_PER_SLAB > 0, "node does not fit in a slab");
+
+	static void* allocate(){
+	    auto& l = local_list();
+	    if(l.head == nullptr)
+		refill(l);
+	    auto node = l.head;
+	    l.head = node->next;
+	    l.cnt.store(l.cnt.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+	    return static_cast<void*>(node);
+	}
+
+	static void deallocate(void* ptr){
+	    auto& l = local_list();
+	    auto node = static_cast<free_node_t*>(ptr);
+	    node->next = l.head;
+	    l.head = node;
+	    auto cnt = l.cnt.load(std::memory_order_relaxed) + 1;
+	    l.cnt.store(cnt, std::memory_order_relaxed);
+	    if(cnt > LOCAL_MAX)
+		spill(l, BATCH);
+	}
+
+	/* live: bytes handed out as nodes, pooled: bytes cached in free lists or not carved yet */
+	static void footprint(uint64_t& live, uint64_t& pooled){
+	    std::lock_guard<std::mutex> guard(lock);
+	    uint64_t free_num = shared_cnt + (slab_end - slab_cur) / NODE_SIZE;
+	    for(auto l=lists; l!=nullptr; l=l->next_list)
+		free_num += l->cnt.load(std::memory_order_relaxed);
+	    pooled = free_num * NODE_SIZE;
+	    live = slab_num * NODES_PER_SLAB * NODE_SIZE - pooled;
+	}
+
+    private:
+	struct free_node_t{
+	    free_node_t* next;
+	};
+
+	struct local_list_t{
+	    free_node_t* head = nullptr;
+	    std::atomic<size_t> cnt{0}; // written by the owner only, read by footprint()
+	    local_list_t* next_list = nullptr;
+	    local_list_t* prev_list = nullptr;
+
+	    local_list_t(){
+		std::lock_guard<std::mutex> guard(lock);
+		next_list = lists;
+		if(lists) lists->prev_list = this;
+		lists = this;
+	    }
+
+	    // hand the cached nodes back when the thread exits
+	    ~local_list_t(){
+		spill(*this, cnt.load());
+		std::lock_guard<std::mutex> guard(lock);
+		if(prev_list) prev_list->next_list = next_list;
+		else lists = next_list;
+		if(next_list) next_list->prev_list = prev_list;
+	    }
+	};
+
+	static inline std::mutex lock;
+	static inline free_node_t* shared = nullptr;
+	static inline size_t shared_cnt = 0;
+	static inline char* slab_cur = nullptr;
+	static inline char* slab_end = nullptr;
+	static inline size_t slab_num = 0;
+	static inline local_list_t* lists = nullptr;
+
+	static local_list_t& local_list(){
+	    static thread_local local_list_t l;
+	    return l;
+	}
+
+	static void refill(local_list_t& l){
+	    std::lock_guard<std::mutex> guard(lock);
+	    size_t num = 0;
+	    while(num < BATCH){
+		free_node_t* node;
+		if(shared){
+		    node = shared;
+		    shared = node->next;
+		    shared_cnt--;
+		}
+		else{
+		    if(slab_cur == slab_end)
+			new_slab();
+		    node = reinterpret_cast<free_node_t*>(slab_cur);
+		    slab_cur += NODE_SIZE;
+		}
+		node->next = l.head;
+		l.head = node;
+		num++;
+	    }
+	    l.cnt.store(l.cnt.load(std::memory_order_relaxed) + num, std::memory_order_relaxed);
+	}
+
+	static void spill(local_list_t& l, size_t num){
+	    std::lock_guard<std::mutex> guard(lock);
+	    for(size_t i=0; i<num && l.head; i++){
+		auto node = l.head;
+		l.head = node->next;
+		node->next = shared;
+		shared = node;
+		shared_cnt++;
+		l.cnt.store(l.cnt.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+	    }
+	}
+
+	// called with the lock held
+	static void new_slab(){
+	    // over-allocate to align the slab on a huge page boundary
+	    auto raw = static_cast<char*>(mmap(nullptr, SLAB_SIZE*2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	    if(raw == MAP_FAILED)
+		throw std::bad_alloc();
+	    auto slab = reinterpret_cast<char*>(((uintptr_t)raw + SLAB_SIZE - 1) & ~(uintptr_t)(SLAB_SIZE - 1));
+	    if(slab != raw)
+		munmap(raw, slab - raw);
+	    munmap(slab + SLAB_SIZE, raw + SLAB_SIZE - slab);
+	    #ifdef MADV_HUGEPAGE
+	    madvise(slab, SLAB_SIZE, MADV_HUGEPAGE);
+	    #endif
+	    // prefault once here instead of on the first touch of every split
+	    madvise(slab, SLAB_SIZE, MADV_WILLNEED);
+	    for(size_t i=0; i<SLAB_SIZE; i+=4096)
+		slab[i] = 0;
+
+	    slab_cur = slab;
+	    slab_end = slab + NODES_PER_SLAB * NODE_SIZE;
+	    slab_num++;
+	}
+};
+
+}
+#endif
@@ -2,19 +2,94 @@
 
 namespace BLINK_HASH{
 
-template <typename Key_t, typename Value_t>
-int btree_t<Key_t, Value_t>::check_height(){
+#ifdef BREAKDOWN
+static thread_local uint64_t time_traversal;
+static thread_local uint64_t time_abort;
+static thread_local uint64_t time_node;
+static thread_local uint64_t time_split;
+static thread_local uint64_t inserts;
+static thread_local uint64_t inner_reads; // inner nodes visited by inserts, restarts included
+#endif
+
+/* the cause a restart is counted under: a conflict on the version of a hash leaf comes from a split of it or
+   from its conversion, one that was retired without being converted has been merged away */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+static restart_cause_t restart_cause(const conflict_t& last){
+    if((last.cause != RESTART_VERSION) || (last.node == nullptr))
+	return last.cause;
+    auto node = static_cast<const node_t*>(last.node);
+    if(node->level != 0)
+	return RESTART_VERSION;
+    auto leaf = static_cast<const lnode_t<Key_t, Value_t, Geometry_t>*>(node);
+    if(leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	return RESTART_VERSION;
+    if((static_cast<const lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->converting)
+	return RESTART_CONVERT;
+    return (last.seen & 1) ? RESTART_VERSION : RESTART_SPLIT;
+}
+
+/* the root is allocated here rather than in the header, so that leaves always come
+   from the allocator the library was built with (see NODE_POOL) */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+btree_t<Key_t, Value_t, Geometry_t>::btree_t(){
+    root = static_cast<node_t*>(new lnode_hash_t<Key_t, Value_t, Geometry_t>());
+    #ifndef FINGERPRINT
+    memset(&EMPTY<Key_t>, 0, sizeof(EMPTY<Key_t>));
+    #endif
+}
+
+/* frees every node reachable from the root level by level,
+   nodes retired through the epoch are freed when epoche is destroyed */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+btree_t<Key_t, Value_t, Geometry_t>::~btree_t(){
+    stop_converter();
+    stop_sweeper();
+
+    auto leftmost = root;
+    while(leftmost){
+	auto next_level = (leftmost->level != 0) ? leftmost->leftmost_ptr : nullptr;
+	auto cur = leftmost;
+	while(cur){
+	    auto sibling = cur->sibling_ptr;
+	    delete_node(cur);
+	    cur = sibling;
+	}
+	leftmost = next_level;
+    }
+    root = nullptr;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::check_height(){
     auto ret = utilization();
     return root->level;
 }
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epocheThreadInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::insert(Key_t key, Value_t value, ThreadInfo& epocheThreadInfo){
     EpocheGuard epocheGuard(epocheThreadInfo);
+    #ifdef BREAKDOWN
+    uint64_t start = _rdtsc(), end;
+    inserts++;
+    #endif
+    key = key_traits_t<Key_t>::store(arena, key);
+    if(tail_enabled && insert_tail(key, value)){
+	#ifdef BREAKDOWN
+	time_node += _rdtsc() - start;
+	#endif
+	return;
+    }
+    backoff_t backoff;
     restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    #ifdef BREAKDOWN
+    end = _rdtsc();
+    time_abort += end - start;
+    start = end;
+    #endif
     auto cur = root;
     int stack_cnt = 0;
-    inode_t<Key_t>* stack[root->level];
+    inode_t<Key_t, Geometry_t>* stack[cur->level];
 
     bool need_restart = false;
     auto cur_vstart = cur->try_readlock(need_restart);
@@ -23,27 +98,33 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 
     // tree traversal
     while(cur->level != 0){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key);
+	#ifdef BREAKDOWN
+	inner_reads++;
+	#endif
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
 	auto child_vstart = child->try_readlock(need_restart);
-	if(need_restart)
+	if(need_restart){
+	    if(child->level == 0) // leaf being split, help migrating it instead of spinning
+		(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(child))->help_split();
 	    goto restart;
+	}
 
 	auto cur_vend = cur->get_version(need_restart);
 	if(need_restart || (cur_vstart != cur_vend))
 	    goto restart;
 
 	if(child != cur->sibling_ptr)
-	    stack[stack_cnt++] = static_cast<inode_t<Key_t>*>(cur);
+	    stack[stack_cnt++] = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
 
 	cur = child;
 	cur_vstart = child_vstart;
     }
     // found leaf
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     auto leaf_vstart = cur_vstart;
 
     while(leaf->sibling_ptr && (leaf->high_key < key)){
-	auto sibling = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr);
+	auto sibling = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
 	auto sibling_v = sibling->try_readlock(need_restart);
 	if(need_restart)
 	    goto restart;
@@ -55,17 +136,51 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 	leaf = sibling;
 	leaf_vstart = sibling_v;
     }
+    #ifdef BREAKDOWN
+    end = _rdtsc();
+    time_traversal += end - start;
+    start = end;
+    #endif
 
     auto ret = leaf->insert(key, value, leaf_vstart);
     if(ret == -1) // leaf node has been split while inserting
 	goto restart;
-    else if(ret == 0) // insertion succeeded
+    else if(ret == 0){ // insertion succeeded
+	#ifdef BREAKDOWN
+	time_node += _rdtsc() - start;
+	#endif
 	return;
+    }
     else{ // leaf node split
+	#ifdef BREAKDOWN
+	end = _rdtsc();
+	time_node += end - start;
+	start = end;
+	#endif
+	if((overflow_util > 0) && leaf->sibling_ptr && (leaf->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)){
+	    // late keys overflowed an older leaf, which is unlikely to fill up two halves of a split
+	    auto leaf_vend = leaf->get_version(need_restart);
+	    if(need_restart || (leaf_vstart != leaf_vend)) // split by another thread since
+		goto restart;
+	    if((static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->utilization() >= overflow_util){
+		if(convert(leaf, leaf_vstart, epocheThreadInfo))
+		    overflow_converted.fetch_add(1, std::memory_order_relaxed);
+		conflict(RESTART_CONVERT, nullptr, nullptr, 0);
+		goto restart;
+	    }
+	    overflow_split.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto split_start = _rdtsc();
 	Key_t split_key;
 	auto new_leaf = leaf->split(split_key, key, value, leaf_vstart);
 	if(new_leaf == nullptr)
 	    goto restart; // another thread has already splitted this leaf node
+	leaf_splits.fetch_add(1, std::memory_order_relaxed);
+	if(new_leaf->sibling_ptr == nullptr) // split off the rightmost leaf
+	    set_tail(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(new_leaf), split_key);
+	if(sweeper)
+	    queue_sweep(split_key);
 
 	if(stack_cnt){
 	    int stack_idx = stack_cnt-1;
@@ -75,11 +190,19 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 	    auto new_node = static_cast<node_t*>(new_leaf);
 	    while(stack_idx > -1){ // backtrack parent nodes
 		old_parent = stack[stack_idx];
+		backoff_t parent_backoff;
 	    	parent_restart:
+		parent_backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
 		need_restart = false;
 		auto parent_vstart = old_parent->try_readlock(need_restart);
-		if(need_restart)
+		if(need_restart){
+		    if(old_parent->is_obsolete(parent_vstart)){ // merged away since the descent
+			insert_key(split_key, new_node, original_node);
+			split_done(split_start);
+			return;
+		    }
 		    goto parent_restart;
+		}
 
 		while(old_parent->sibling_ptr && (old_parent->high_key < split_key)){
 		    auto p_sibling = old_parent->sibling_ptr;
@@ -91,7 +214,7 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 		    if(need_restart || (parent_vstart != parent_vend))
 			goto parent_restart;
 
-		    old_parent = static_cast<inode_t<Key_t>*>(p_sibling);
+		    old_parent = static_cast<inode_t<Key_t, Geometry_t>*>(p_sibling);
 		    parent_vstart = p_sibling_v;
 		}
 
@@ -102,17 +225,19 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 		if(original_node->level != 0) // internal node
 		    original_node->write_unlock();
 		else // leaf node
-		    (static_cast<lnode_t<Key_t, Value_t>*>(original_node))->write_unlock();
+		    (static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(original_node))->write_unlock();
 
 		if(!old_parent->is_full()){ // normal insert
 		    old_parent->insert(split_key, new_node);
 		    old_parent->write_unlock();
+		    split_done(split_start);
 		    return;
 		}
 
 		// internal node split
 		Key_t _split_key;
 		auto new_parent = old_parent->split(_split_key);
+		inner_splits.fetch_add(1, std::memory_order_relaxed);
 
 		if(split_key <= _split_key)
 		    old_parent->insert(split_key, new_node);
@@ -127,42 +252,333 @@ void btree_t<Key_t, Value_t>::insert(Key_t key, Value_t value, ThreadInfo& epoch
 		}
 		else{ // set new root
 		    if(old_parent == root){ // current node is root
-			auto new_root = new inode_t<Key_t>(_split_key, old_parent, new_parent, nullptr, old_parent->level+1, new_parent->high_key);
+			auto new_root = new inode_t<Key_t, Geometry_t>(_split_key, old_parent, new_parent, nullptr, old_parent->level+1, new_parent->high_key);
 			root = static_cast<node_t*>(new_root);
 			old_parent->write_unlock();
 		    }
 		    else // other thread has already created a new root
 			insert_key(_split_key, new_parent, old_parent);
+		    split_done(split_start);
 		    return;
 		}
 	    }
 	}
 	else{ // set new root
 	    if(root == leaf){ // current node is root
-		auto new_root = new inode_t<Key_t>(split_key, leaf, new_leaf, nullptr, root->level+1, (static_cast<lnode_t<Key_t, Value_t>*>(new_leaf))->high_key);
+		auto new_root = new inode_t<Key_t, Geometry_t>(split_key, leaf, new_leaf, nullptr, root->level+1, (static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(new_leaf))->high_key);
 		root = static_cast<node_t*>(new_root);
 		leaf->write_unlock();
 	    }
 	    else // other thread has already created a new root
 		insert_key(split_key, new_leaf, leaf);
 	}
+	split_done(split_start);
+    }
+}
+
+/* inserts into the cached rightmost hash leaf without traversing from the root,
+   returns false if the cache is stale, the key lies left of the leaf or the leaf needs to be split */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::insert_tail(Key_t key, Value_t value){
+    auto seq = tail_seq.load(std::memory_order_acquire);
+    if(seq & 1)
+	return false;
+    auto leaf = tail_leaf;
+    auto low_key = tail_low;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if((tail_seq.load(std::memory_order_relaxed) != seq) || !leaf || !(low_key < key))
+	return false;
+
+    bool need_restart = false;
+    auto leaf_vstart = leaf->try_readlock(need_restart);
+    if(need_restart){ // locked or retired
+	(static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->help_split();
+	return false;
+    }
+    if(leaf->sibling_ptr) // no longer the rightmost leaf
+	return false;
+
+    // the hash leaf validates leaf_vstart under the bucket lock, so a split in between is caught there
+    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->insert(key, value, leaf_vstart) == 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+uint64_t btree_t<Key_t, Value_t, Geometry_t>::tail_writelock(){
+    auto seq = tail_seq.load();
+    while((seq & 1) || !tail_seq.compare_exchange_weak(seq, seq+1)){
+	_mm_pause();
+	seq = tail_seq.load();
+    }
+    return seq;
+}
+
+/* the leaf is checked under the tail lock, so a leaf retired by drop_tail can never be published afterwards */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::set_tail(lnode_t<Key_t, Value_t, Geometry_t>* leaf, Key_t low_key){
+    if(leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)
+	return;
+
+    auto seq = tail_writelock();
+    if(!leaf->is_obsolete(leaf->lock.load()) && !leaf->sibling_ptr){
+	tail_leaf = leaf;
+	tail_low = low_key;
+    }
+    tail_seq.store(seq+2, std::memory_order_release);
+}
+
+/* called after the leaf is marked obsolete and before it is retired */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::drop_tail(lnode_t<Key_t, Value_t, Geometry_t>* leaf){
+    auto seq = tail_writelock();
+    if(tail_leaf == leaf)
+	tail_leaf = nullptr;
+    tail_seq.store(seq+2, std::memory_order_release);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::set_tail_cache(bool enable){
+    tail_enabled = enable;
+}
+
+/* a leaf split holds up writers of that leaf from the split until the parent is updated */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::split_done(uint64_t split_start){
+    auto cycles = _rdtsc() - split_start;
+    #ifdef BREAKDOWN
+    time_split += cycles;
+    #endif
+    int bucket = cycles ? 63 - __builtin_clzll(cycles) : 0;
+    if(bucket >= split_stall_buckets)
+	bucket = split_stall_buckets - 1;
+    split_stall[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::split_stall_stats(uint64_t* hist){
+    for(int i=0; i<split_stall_buckets; i++)
+	hist[i] = split_stall[i].load();
+}
+
+#ifdef BREAKDOWN
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::get_breakdown(uint64_t& _time_traversal, uint64_t& _time_abort, uint64_t& _time_latch, uint64_t& _time_node, uint64_t& _time_split, uint64_t& _time_consolidation){
+    _time_traversal = time_traversal;
+    _time_abort = time_abort;
+    _time_latch = 0;
+    _time_node = time_node;
+    _time_split = time_split;
+    _time_consolidation = 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::insert_traversal_stats(uint64_t& _inserts, uint64_t& _inner_reads){
+    _inserts = inserts;
+    _inner_reads = inner_reads;
+}
+#endif
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::insert_batch(const entry_t<Key_t, Value_t>* buf, size_t num, ThreadInfo& threadEpocheInfo){
+    if(num == 0)
+	return;
+
+    auto sorted = new entry_t<Key_t, Value_t>[num];
+    memcpy(sorted, buf, sizeof(entry_t<Key_t, Value_t>)*num);
+    if constexpr(!key_traits_t<Key_t>::flat){
+	for(size_t i=0; i<num; i++)
+	    sorted[i].key = key_traits_t<Key_t>::store(arena, sorted[i].key);
+    }
+    std::sort(sorted, sorted+num, [](entry_t<Key_t, Value_t>& a, entry_t<Key_t, Value_t>& b){
+	    return a.key < b.key;
+	    });
+
+    size_t idx = 0;
+    while(idx < num){
+	if(insert_leaf_batch(sorted, idx, num, threadEpocheInfo)){ // leaf is full, split it through the normal path
+	    insert(sorted[idx].key, sorted[idx].value, threadEpocheInfo);
+	    idx++;
+	}
+    }
+    delete[] sorted;
+}
+
+// runs fn(i) for every i in [0, num), in contiguous chunks over num_threads threads
+template <typename Fn>
+static void parallel_for(size_t num, int num_threads, Fn fn){
+    if((num_threads <= 1) || (num < (size_t)num_threads)){
+	for(size_t i=0; i<num; i++)
+	    fn(i);
+	return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (num + num_threads - 1) / num_threads;
+    for(size_t from=0; from<num; from+=chunk){
+	auto to = std::min(num, from + chunk);
+	threads.emplace_back([&fn, from, to](){
+		for(size_t i=from; i<to; i++)
+		    fn(i);
+		});
+    }
+    for(auto& t: threads)
+	t.join();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::bulk_load(const entry_t<Key_t, Value_t>* sorted, size_t num, double fill, int num_threads){
+    auto tail = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(root);
+    if((root->level != 0) || (tail->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) || tail->count())
+	return false;
+    if(num == 0)
+	return true;
+
+    // keys referring to caller's data are copied into the arena first
+    std::vector<entry_t<Key_t, Value_t>> stored;
+    if constexpr(!key_traits_t<Key_t>::flat){
+	stored.resize(num);
+	parallel_for(num, num_threads, [&](size_t i){
+		stored[i].key = key_traits_t<Key_t>::store(arena, sorted[i].key);
+		stored[i].value = sorted[i].value;
+		});
+	sorted = stored.data();
+    }
+
+    // leaves, key[i] is the separator left of node[i] and the empty hash leaf at the root goes last
+    int leaf_size = std::max(1, std::min((int)lnode_btree_t<Key_t, Value_t, Geometry_t>::cardinality, (int)(lnode_btree_t<Key_t, Value_t, Geometry_t>::cardinality * fill)));
+    int leaf_num = (num + leaf_size - 1) / leaf_size;
+    std::vector<Key_t> key(leaf_num + 1);
+    std::vector<node_t*> node(leaf_num + 1);
+    parallel_for(leaf_num, num_threads, [&](size_t i){
+	    auto leaf = new lnode_btree_t<Key_t, Value_t, Geometry_t>();
+	    size_t start = i * leaf_size;
+	    int from = 0;
+	    leaf->batch_insert(sorted + start, leaf_size, from, std::min(num - start, (size_t)leaf_size));
+	    node[i] = leaf;
+	    key[i] = start ? sorted[start-1].key : Key_t{};
+	    });
+    key[leaf_num] = sorted[num-1].key;
+    node[leaf_num] = tail;
+    for(int i=0; i<leaf_num; i++)
+	node[i]->sibling_ptr = node[i+1];
+    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(tail))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(node[leaf_num-1]);
+
+    // inner levels, each parent takes the next batch_size+1 children as batch_insert fills a new node
+    int batch_size = std::max(1, std::min((int)inode_t<Key_t, Geometry_t>::cardinality - 1, (int)(inode_t<Key_t, Geometry_t>::cardinality * fill)));
+    int level = 1;
+    while(node.size() > 1){
+	int child_num = node.size();
+	int parent_num = (child_num + batch_size) / (batch_size + 1);
+	std::vector<Key_t> parent_key(parent_num);
+	std::vector<node_t*> parent(parent_num);
+	parallel_for(parent_num, num_threads, [&](size_t i){
+		auto inode = new inode_t<Key_t, Geometry_t>(level);
+		int idx = i * (batch_size + 1);
+		parent_key[i] = key[idx];
+		inode->bulk_load(key.data(), node.data(), idx, child_num, batch_size);
+		parent[i] = inode;
+		});
+	for(int i=0; i<parent_num-1; i++)
+	    parent[i]->sibling_ptr = parent[i+1];
+	(static_cast<inode_t<Key_t, Geometry_t>*>(parent[parent_num-1]))->high_key = tail->high_key; // as a root split passes on the rightmost one
+	key.swap(parent_key);
+	node.swap(parent);
+	level++;
+    }
+
+    root = node[0];
+    set_tail(tail, sorted[num-1].key);
+    return true;
+}
+
+/* inserts the run of sorted keys starting from idx that belongs to a single leaf with one traversal,
+   returns true if the leaf needs to be split */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::insert_leaf_batch(entry_t<Key_t, Value_t>* buf, size_t& idx, size_t num, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto key = buf[idx].key;
+    auto cur = root;
+    bool need_restart = false;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    // tree traversal
+    while(cur->level != 0){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    // found leaf
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+
+    while(leaf->sibling_ptr && (leaf->high_key < key)){
+	auto sibling = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto leaf_vend = (static_cast<node_t*>(leaf))->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend))
+	    goto restart;
+
+	leaf = sibling;
+	leaf_vstart = sibling_v;
+    }
+
+    // keys destined for this leaf (validated by the leaf version in insert_batch)
+    size_t to = num;
+    if(leaf->sibling_ptr){
+	auto high_key = leaf->high_key;
+	to = idx;
+	while(to < num && buf[to].key <= high_key)
+	    to++;
     }
+
+    int inserted = 0;
+    auto ret = leaf->insert_batch(buf+idx, to-idx, inserted, leaf_vstart);
+    idx += inserted;
+    if(ret == -1) // leaf node has been updated, restart only for the remaining keys
+	goto restart;
+    return (ret == 1);
 }
 
 /* this function is called when root has been split by another threads */
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::insert_key(Key_t key, node_t* value, node_t* prev){
+    backoff_t backoff;
     restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
     auto cur = root;
     bool need_restart = false;
 
+    if(cur == prev){ // parent of prev was merged away and prev took its place as the root
+	auto node = static_cast<inode_t<Key_t, Geometry_t>*>(prev);
+	auto new_root = new inode_t<Key_t, Geometry_t>(key, node, value, nullptr, node->level+1, (static_cast<inode_t<Key_t, Geometry_t>*>(value))->high_key);
+	root = static_cast<node_t*>(new_root);
+	node->write_unlock();
+	return;
+    }
+
     auto cur_vstart = cur->try_readlock(need_restart);
     if(need_restart)
 	goto restart;
 
     // since we need to find exact internal node which has been previously the root, we use readlock for traversal
     while(cur->level != prev->level+1){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key);
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
 	    goto restart;
@@ -176,7 +592,7 @@ void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev)
     }
 
     // found parent of prev node
-    while(cur->sibling_ptr && ((static_cast<inode_t<Key_t>*>(cur))->high_key < key)){
+    while(cur->sibling_ptr && ((static_cast<inode_t<Key_t, Geometry_t>*>(cur))->high_key < key)){
 	auto sibling = cur->sibling_ptr;
 	auto sibling_vstart = sibling->try_readlock(need_restart);
 	if(need_restart)
@@ -186,7 +602,7 @@ void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev)
 	if(need_restart || (cur_vstart != cur_vend))
 	    goto restart;
 
-	cur = static_cast<inode_t<Key_t>*>(sibling);
+	cur = static_cast<inode_t<Key_t, Geometry_t>*>(sibling);
 	cur_vstart = sibling_vstart;
     }
 
@@ -197,9 +613,9 @@ void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev)
     if(prev->level != 0)
 	prev->write_unlock();
     else
-	(static_cast<lnode_t<Key_t, Value_t>*>(prev))->write_unlock();
+	(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(prev))->write_unlock();
 
-    auto node = static_cast<inode_t<Key_t>*>(cur);
+    auto node = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
     if(!node->is_full()){
 	node->insert(key, value);
 	node->write_unlock();
@@ -207,13 +623,14 @@ void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev)
     else{
 	Key_t split_key;
 	auto new_node = node->split(split_key);
+	inner_splits.fetch_add(1, std::memory_order_relaxed);
 	if(key <= split_key)
 	    node->insert(key, value);
 	else
 	    new_node->insert(key, value);
 
 	if(node == root){ // if current nodes is root
-	    auto new_root = new inode_t<Key_t>(split_key, node, new_node, nullptr, node->level+1, new_node->high_key);
+	    auto new_root = new inode_t<Key_t, Geometry_t>(split_key, node, new_node, nullptr, node->level+1, new_node->high_key);
 	    root = static_cast<node_t*>(new_root);
 	    node->write_unlock();
 	}
@@ -222,10 +639,12 @@ void btree_t<Key_t, Value_t>::insert_key(Key_t key, node_t* value, node_t* prev)
     }
 }
 
-template <typename Key_t, typename Value_t>
-bool btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, ThreadInfo& threadEpocheInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::update(Key_t key, Value_t value, ThreadInfo& threadEpocheInfo){
     EpocheGuardReadonly epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
     restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
     auto cur = root;
     bool need_restart = false;
     auto cur_vstart = cur->try_readlock(need_restart);
@@ -233,7 +652,7 @@ bool btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, ThreadInfo& threa
 
     // traversal
     while(cur->level != 0){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key);
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart) goto restart;
 
@@ -246,7 +665,7 @@ bool btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, ThreadInfo& threa
     }
 
     // found leaf
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     auto leaf_vstart = cur_vstart;
 
     // move right if necessary
@@ -258,7 +677,7 @@ bool btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, ThreadInfo& threa
 	auto leaf_vend = leaf->get_version(need_restart);
 	if(need_restart || (leaf_vstart != leaf_vend)) goto restart;
 
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(sibling);
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
 	leaf_vstart = sibling_v;
     }
 
@@ -270,10 +689,12 @@ bool btree_t<Key_t, Value_t>::update(Key_t key, Value_t value, ThreadInfo& threa
     return false;
 }
 
-template <typename Key_t, typename Value_t>
-bool btree_t<Key_t, Value_t>::remove(Key_t key, ThreadInfo& threadEpocheInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::remove(Key_t key, ThreadInfo& threadEpocheInfo){
     EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
     restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
     auto cur = root;
     bool need_restart = false;
 
@@ -283,7 +704,7 @@ bool btree_t<Key_t, Value_t>::remove(Key_t key, ThreadInfo& threadEpocheInfo){
 
     // traversal
     while(cur->level != 0){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key);
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
 	    goto restart;
@@ -297,7 +718,7 @@ bool btree_t<Key_t, Value_t>::remove(Key_t key, ThreadInfo& threadEpocheInfo){
     }
 
     // found leaf
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     auto leaf_vstart = cur_vstart;
 
     // move right if necessary
@@ -310,147 +731,608 @@ bool btree_t<Key_t, Value_t>::remove(Key_t key, ThreadInfo& threadEpocheInfo){
 	auto leaf_vend = leaf->get_version(need_restart);
 	if(need_restart || (leaf_vstart != leaf_vend)) goto restart;
 
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(sibling);
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
 	leaf_vstart = sibling_v;
     }
 
     auto ret = leaf->remove(key, leaf_vstart);
     if(ret == -1) // leaf node has been updated
 	goto restart;
-    else if(ret == 0)
+    else if(ret == 0){
+	if((merge_threshold > 0) && leaf->sibling_ptr && (leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) && (leaf->utilization() < merge_threshold))
+	    merge_node(key, 0, threadEpocheInfo);
 	return true;
+    }
     else
 	return false;
 }
 
+template <typename Key_t, typename Value_t, typename Geometry_t>
+uint64_t btree_t<Key_t, Value_t, Geometry_t>::remove_range(Key_t lo, Key_t hi, ThreadInfo& threadEpocheInfo){
+    if(hi < lo)
+	return 0;
+    uint64_t removed = 0;
+    Key_t key = lo;
+    bool first = true;
+    std::vector<Key_t> underfull;
+    int ret;
+    // the epoch is entered per step here and per merge below, with only keys kept in between
+    while((ret = remove_range_step(key, first, lo, hi, removed, underfull, threadEpocheInfo)) != 0){
+	if(ret == -1) // lost a lock race, the step is retried from where the last one stopped
+	    _mm_pause();
+    }
 
-template <typename Key_t, typename Value_t>
-Value_t btree_t<Key_t, Value_t>::lookup(Key_t key, ThreadInfo& threadEpocheInfo){
-    EpocheGuardReadonly epocheGuard(threadEpocheInfo);
-    restart:
-    auto cur = root;
-    bool need_restart = false;
+    // parents left with a single child merge into a neighbour, then the boundary leaves below the threshold do too
+    for(auto k: underfull){
+	for(int level=1; level>=0; level--){
+	    EpocheGuard epocheGuard(threadEpocheInfo);
+	    merge_node(k, level, threadEpocheInfo);
+	}
+    }
+    return removed;
+}
 
+/* one parent worth of remove_range with the parent write-locked: the leaf covering lo the first time,
+   otherwise the leaves after the one covering key, which is the high key of the last leaf dealt with;
+   returns 0 once the range is done, 1 with key moved on and -1 if a lock could not be taken */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::remove_range_step(Key_t& key, bool& first, Key_t lo, Key_t hi, uint64_t& removed, std::vector<Key_t>& underfull, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    bool need_restart = false;
+    auto cur = root;
     auto cur_vstart = cur->try_readlock(need_restart);
     if(need_restart)
-	goto restart;
+	return -1;
+
+    if(cur->level == 0){ // a single leaf
+	auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+	if(!lock_for_merge(leaf, true))
+	    return -1;
+	if(root != cur){ // split since
+	    unlock_for_merge(leaf, true, false);
+	    return -1;
+	}
+	removed += leaf->remove_range(lo, hi);
+	unlock_for_merge(leaf, true, false);
+	return 0;
+    }
 
-    // traversal
-    while(cur->level != 0){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key);
+    while(cur->level != 1){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
-	    goto restart;
+	    return -1;
 
 	auto cur_vend = cur->get_version(need_restart);
 	if(need_restart || (cur_vstart != cur_vend))
-	    goto restart;
+	    return -1;
 
 	cur = child;
 	cur_vstart = child_vstart;
     }
 
-    // found leaf
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
-    auto leaf_vstart = cur_vstart;
+    auto parent = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
+    while(parent->sibling_ptr && (parent->high_key < key)){
+	auto sibling = parent->sibling_ptr;
+	auto sibling_vstart = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    return -1;
 
-    // move right if necessary
-    while(leaf->sibling_ptr && (leaf->high_key < key)){
-	auto sibling = leaf->sibling_ptr;
+	auto parent_vend = parent->get_version(need_restart);
+	if(need_restart || (cur_vstart != parent_vend))
+	    return -1;
 
-	auto sibling_v = sibling->try_readlock(need_restart);
-	if(need_restart) goto restart;
+	parent = static_cast<inode_t<Key_t, Geometry_t>*>(sibling);
+	cur_vstart = sibling_vstart;
+    }
 
-	auto leaf_vend = leaf->get_version(need_restart);
-	if(need_restart || (leaf_vstart != leaf_vend)) goto restart;
+    parent->try_upgrade_writelock(cur_vstart, need_restart);
+    if(need_restart)
+	return -1;
+
+    int pos = parent->find_lowerbound(key);
+    auto left = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(parent->child(pos));
+    if(first){ // the leaf covering lo loses its keys one by one
+	if(!lock_for_merge(left, true)){
+	    parent->write_unlock();
+	    return -1;
+	}
+	removed += left->remove_range(lo, hi);
+	bool done = (left->sibling_ptr == nullptr) || (hi <= left->high_key);
+	key = left->high_key;
+	first = false;
+	if((left->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) && (left->utilization() < merge_threshold))
+	    underfull.push_back(key);
+	unlock_for_merge(left, true, false);
+	parent->write_unlock();
+	return done ? 0 : 1;
+    }
 
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(sibling);
-	leaf_vstart = sibling_v;
+    if(left->sibling_ptr == nullptr){
+	parent->write_unlock();
+	return 0;
     }
-    auto ret = leaf->find(key, need_restart);
-    if(need_restart) goto restart;
 
-    auto leaf_vend = leaf->get_version(need_restart);
-    if(need_restart || (leaf_vstart != leaf_vend))
-	goto restart;
-    return ret;
+    // the run starts right of left, in the sibling of parent if left is its last child
+    int from = pos+1;
+    if(from == parent->get_cnt()){
+	auto sibling = static_cast<inode_t<Key_t, Geometry_t>*>(parent->sibling_ptr);
+	if(sibling == nullptr){ // left has just split, its new sibling is not in a parent yet
+	    parent->write_unlock();
+	    return -1;
+	}
+	if(!sibling->try_writelock()){
+	    parent->write_unlock();
+	    return -1;
+	}
+	parent->write_unlock();
+	parent = sibling;
+	from = -1;
+    }
+
+    if(!lock_for_merge(left, false)){
+	parent->write_unlock();
+	return -1;
+    }
+
+    // leaves inside the range, the last child stays if the run would take every child of parent
+    lnode_t<Key_t, Value_t, Geometry_t>* run[inode_t<Key_t, Geometry_t>::cardinality+1];
+    int num = 0;
+    int last = parent->get_cnt()-1;
+    bool locked = true;
+    auto prev = left;
+    for(int i=from; i<=last; i++){
+	if((from == -1) && (i == last))
+	    break;
+	auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(parent->child(i));
+	if((prev->sibling_ptr != leaf) || (leaf->sibling_ptr == nullptr) || (hi < leaf->high_key))
+	    break;
+	if(!lock_for_merge(leaf, true)){
+	    locked = false;
+	    break;
+	}
+	if((leaf->sibling_ptr == nullptr) || (hi < leaf->high_key)){ // split or merged into since read
+	    unlock_for_merge(leaf, true, false);
+	    break;
+	}
+	run[num++] = leaf;
+	prev = leaf;
+    }
+
+    if(num){
+	auto next = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(run[num-1]->sibling_ptr);
+	left->sibling_ptr = next;
+	if(from >= 0) // left takes over the range of the run, from the leftmost child on the parent boundary stays put
+	    left->high_key = run[num-1]->high_key;
+	if(next->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) // the last of the run held the lock that guards it
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(next))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(left);
+	parent->remove_children(from, num);
+	for(int i=0; i<num; i++){
+	    removed += run[i]->count();
+	    unlock_for_merge(run[i], true, true);
+	    drop_tail(run[i]);
+	    threadEpocheInfo.getEpoche().markNodeForDeletion(run[i], threadEpocheInfo);
+	}
+	merged_nodes.fetch_add(num, std::memory_order_relaxed);
+    }
+    // the leaf right of the run is the other end of the range, the kept last child or one the run stopped at
+    key = left->high_key;
+    bool has_next = (from < parent->get_cnt());
+    auto next = has_next ? static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(parent->child(from)) : nullptr;
+    bool linked = (left->sibling_ptr == next);
+    unlock_for_merge(left, false, false);
+    if(!has_next){ // the run took the rest of parent
+	parent->write_unlock();
+	return locked ? 1 : -1;
+    }
+    if(!locked || !linked || !lock_for_merge(next, true)){ // a split of the run or of left is yet to reach parent
+	parent->write_unlock();
+	return -1;
+    }
+
+    removed += next->remove_range(lo, hi);
+    bool done = (next->sibling_ptr == nullptr) || (hi <= next->high_key);
+    key = next->high_key;
+    if((parent->get_cnt() == 0) || ((next->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) && (next->utilization() < merge_threshold)))
+	underfull.push_back(key);
+    unlock_for_merge(next, true, false);
+    parent->write_unlock();
+    return done ? 0 : 1;
 }
 
-template <typename Key_t, typename Value_t>
-inode_t<Key_t>** btree_t<Key_t, Value_t>::new_root_for_adjustment(Key_t* key, node_t** value, int num, int& new_num){
-    int batch_size = inode_t<Key_t>::cardinality * FILL_FACTOR;
-    if(num % batch_size == 0)
-	new_num = num / batch_size;
-    else
-	new_num = num / batch_size + 1;
 
-    auto new_roots = new inode_t<Key_t>*[new_num];
-    int idx = 0;
-    for(int i=0; i<new_num; i++){
-	new_roots[i] = new inode_t<Key_t>(value[0]->level+1); // level
-//	new_roots[i]->batch_insert(key, value, idx, num, batch_size);
-	if(i < new_num-1)
-	    new_roots[i]->sibling_ptr = static_cast<node_t*>(new_roots[i+1]);
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::checkpoint(const char* path, ThreadInfo& threadEpocheInfo){
+    if constexpr(!key_traits_t<Key_t>::flat)
+	return false;
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE* fp = fopen(tmp_path.c_str(), "wb");
+    if(fp == nullptr)
+	return false;
+
+    checkpoint_header_t header = {{'B', 'L', 'I', 'N', 'K', 'H', 'S', 'H'}, checkpoint_header_t::current_version, sizeof(Key_t), sizeof(Value_t), 0, 0};
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+
+    // large enough for any leaf type
+    size_t leaf_max = std::max((size_t)lnode_hash_t<Key_t, Value_t, Geometry_t>::cardinality * lnode_hash_t<Key_t, Value_t, Geometry_t>::entry_num,
+	    (size_t)lnode_btree_t<Key_t, Value_t, Geometry_t>::cardinality);
+    if constexpr(key_traits_t<Key_t>::delta)
+	leaf_max = std::max(leaf_max, (size_t)lnode_delta_t<Key_t, Value_t, Geometry_t>::capacity(1));
+    std::vector<entry_t<Key_t, Value_t>> buf(leaf_max);
+    Key_t key{}, stop_key{};
+    bool first = true;
+    checkpoint_stop_t stop;
+    int ret;
+    // keys appended from here on may be left out, so the walk cannot be outrun by the writers
+    while(!checkpoint_bound(stop_key, stop, buf.data(), threadEpocheInfo))
+	_mm_pause();
+    // each step enters the epoch on its own and only carries keys over, so nodes retired meanwhile can be reclaimed
+    while(ok && ((ret = checkpoint_step(key, first, stop_key, stop, fp, buf.data(), header.num, threadEpocheInfo)) != 0)){
+	if(ret == -1) // lost a lock race, the step is retried from where the last one stopped
+	    _mm_pause();
+	else if(ret == -2)
+	    ok = false;
     }
-    return new_roots;
+
+    ok = ok && (fseek(fp, 0, SEEK_SET) == 0) && (fwrite(&header, sizeof(header), 1, fp) == 1) && (fflush(fp) == 0) && (fsync(fileno(fp)) == 0);
+    ok = (fclose(fp) == 0) && ok;
+    if(ok)
+	ok = (rename(tmp_path.c_str(), path) == 0);
+    if(!ok)
+	unlink(tmp_path.c_str());
+    return ok;
 }
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::batch_insert(Key_t* key, node_t** value, int num, node_t* prev, ThreadInfo& threadEpocheInfo){
-    restart:
+/* finds where checkpoint stops: the largest key of the rightmost leaf, or its low key when it is empty, which
+   is the last separator on the way down (none if it is the leftmost leaf as well);
+   returns false if a lock could not be taken */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::checkpoint_bound(Key_t& stop_key, checkpoint_stop_t& stop, entry_t<Key_t, Value_t>* buf, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
     auto cur = root;
     bool need_restart = false;
-
     auto cur_vstart = cur->try_readlock(need_restart);
     if(need_restart)
-	goto restart;
+	return false;
 
-    while(cur->level != prev->level+1){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(key[0]);
+    bool has_low = false;
+    Key_t low_key{};
+    while(cur->level != 0){
+	auto inode = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
+	auto child = inode->rightmost_ptr();
+	int cnt = inode->get_cnt();
+	if(cnt > 0){
+	    has_low = true;
+	    low_key = inode->separator(cnt-1);
+	}
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
-	    goto restart;
+	    return false;
 
 	auto cur_vend = cur->get_version(need_restart);
 	if(need_restart || (cur_vstart != cur_vend))
-	    goto restart;
+	    return false;
 
 	cur = child;
 	cur_vstart = child_vstart;
     }
 
-    // found parent
-    while(cur->sibling_ptr && ((static_cast<inode_t<Key_t>*>(cur))->high_key < key[0])){
-	auto sibling = cur->sibling_ptr;
-	auto sibling_vstart = sibling->try_readlock(need_restart);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    if(leaf->sibling_ptr || !lock_for_merge(leaf, true))
+	return false;
+    if(leaf->sibling_ptr){
+	unlock_for_merge(leaf, true, false);
+	return false;
+    }
+    int cnt = leaf->collect(buf);
+    unlock_for_merge(leaf, true, false);
+
+    if(cnt > 0){
+	stop = STOP_AT_KEY;
+	stop_key = buf[cnt-1].key;
+    }
+    else if(has_low){
+	stop = STOP_ABOVE_KEY;
+	stop_key = low_key;
+    }
+    else
+	stop = STOP_FIRST_LEAF;
+    return true;
+}
+
+/* copies the leaf right of key, the high key of the last leaf written, or the leftmost leaf the first time;
+   only keys above key are written, as a merge may have moved keys already written into that leaf;
+   returns 0 once the leaf where checkpoint_bound stopped or the rightmost leaf is written,
+   1 with key moved on, -1 if a lock could not be taken and -2 on a write error */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::checkpoint_step(Key_t& key, bool& first, Key_t stop_key, checkpoint_stop_t stop, FILE* fp, entry_t<Key_t, Value_t>* buf, uint64_t& num, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    auto cur = root;
+    bool need_restart = false;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	return -1;
+
+    while(cur->level != 0){
+	auto child = first ? cur->leftmost_ptr : (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
-	    goto restart;
+	    return -1;
 
 	auto cur_vend = cur->get_version(need_restart);
 	if(need_restart || (cur_vstart != cur_vend))
-	    goto restart;
+	    return -1;
 
-	cur = static_cast<inode_t<Key_t>*>(sibling);
-	cur_vstart = sibling_vstart;
+	cur = child;
+	cur_vstart = child_vstart;
     }
 
-    cur->try_upgrade_writelock(cur_vstart, need_restart);
-    if(need_restart)
-	goto restart;
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+    while(!first && leaf->sibling_ptr && !(key < leaf->high_key)){
+	auto sibling = leaf->sibling_ptr;
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    return -1;
 
-    if(prev->level == 0){
-	value[0]->write_unlock();
-	(static_cast<lnode_t<Key_t, Value_t>*>(prev))->convert_unlock_obsolete();
-	threadEpocheInfo.getEpoche().markNodeForDeletion(prev, threadEpocheInfo);
+	auto leaf_vend = leaf->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend))
+	    return -1;
+
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
+	leaf_vstart = sibling_v;
     }
-    else
-	prev->write_unlock();
 
-    auto parent = static_cast<inode_t<Key_t>*>(cur);
-    int new_num = 0;
-    inode_t<Key_t>** new_nodes;
-    if(parent->level == 1)
-	new_nodes = parent->batch_insert_last_level(key, value, num, new_num);
+    if(!lock_for_merge(leaf, true))
+	return -1;
+    if(!first && leaf->sibling_ptr && !(key < leaf->high_key)){ // split since
+	unlock_for_merge(leaf, true, false);
+	return -1;
+    }
+    int cnt = leaf->collect(buf);
+    bool done = (leaf->sibling_ptr == nullptr) || (stop == STOP_FIRST_LEAF)
+	|| ((stop == STOP_AT_KEY) ? !(leaf->high_key < stop_key) : (stop_key < leaf->high_key));
+    auto high_key = leaf->high_key;
+    unlock_for_merge(leaf, true, false);
+
+    int from = 0;
+    if(!first){
+	while((from < cnt) && !(key < buf[from].key))
+	    from++;
+    }
+    if((int)fwrite(&buf[from], sizeof(entry_t<Key_t, Value_t>), cnt-from, fp) != cnt-from)
+	return -2;
+    num += cnt - from;
+    if(cnt > from)
+	key = buf[cnt-1].key;
+    if(!done)
+	key = high_key;
+    first = false;
+    return done ? 0 : 1;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::restore(const char* path, int num_threads){
+    if constexpr(!key_traits_t<Key_t>::flat)
+	return false;
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+	return false;
+    struct stat st;
+    if((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(checkpoint_header_t))){
+	close(fd);
+	return false;
+    }
+    auto addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED)
+	return false;
+
+    auto header = static_cast<const checkpoint_header_t*>(addr);
+    bool ok = (memcmp(header->magic, "BLINKHSH", 8) == 0) && (header->version == checkpoint_header_t::current_version)
+	&& (header->key_size == sizeof(Key_t)) && (header->value_size == sizeof(Value_t))
+	&& ((size_t)st.st_size == sizeof(checkpoint_header_t) + header->num * sizeof(entry_t<Key_t, Value_t>));
+    if(ok)
+	ok = bulk_load(reinterpret_cast<const entry_t<Key_t, Value_t>*>(header + 1), header->num, FILL_FACTOR, num_threads);
+    munmap(addr, st.st_size);
+    return ok;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::lookup(Key_t key, Value_t& value, ThreadInfo& threadEpocheInfo){
+    EpocheGuardReadonly epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto cur = root;
+    bool need_restart = false;
+
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    // traversal
+    while(cur->level != 0){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    // found leaf
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+
+    // move right if necessary
+    while(leaf->sibling_ptr && (leaf->high_key < key)){
+	auto sibling = leaf->sibling_ptr;
+
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart) goto restart;
+
+	auto leaf_vend = leaf->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend)) goto restart;
+
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
+	leaf_vstart = sibling_v;
+    }
+    auto ret = leaf->find(key, value, need_restart);
+    if(need_restart) goto restart;
+
+    auto leaf_vend = leaf->get_version(need_restart);
+    if(need_restart || (leaf_vstart != leaf_vend))
+	goto restart;
+    return ret;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+Value_t btree_t<Key_t, Value_t, Geometry_t>::lookup(Key_t key, ThreadInfo& threadEpocheInfo){
+    Value_t value;
+    if(lookup(key, value, threadEpocheInfo))
+	return value;
+    return 0;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::lookup_batch(const Key_t* keys, Value_t* values, bool* found, size_t num, ThreadInfo& threadEpocheInfo){
+    constexpr size_t group = 16;
+    for(size_t i=0; i<num; i+=group){
+	size_t n = std::min(group, num - i);
+	{
+	    EpocheGuardReadonly epocheGuard(threadEpocheInfo);
+	    prefetch_path(&keys[i], n);
+	}
+	for(size_t j=i; j<i+n; j++)
+	    found[j] = lookup(keys[j], values[j], threadEpocheInfo);
+    }
+}
+
+/* descends for all keys level by level so that up to num node fetches are in flight at once,
+   then prefetches the leaf line each key will probe; nothing is returned, so a key whose
+   node changes under it simply stops being prefetched */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::prefetch_path(const Key_t* keys, size_t num){
+    node_t* cur[num];
+    for(size_t i=0; i<num; i++)
+	cur[i] = root;
+
+    bool descending = true;
+    while(descending){
+	descending = false;
+	for(size_t i=0; i<num; i++){
+	    auto node = cur[i];
+	    if(node == nullptr || node->level == 0)
+		continue;
+
+	    bool need_restart = false;
+	    auto vstart = node->try_readlock(need_restart);
+	    if(need_restart){
+		cur[i] = nullptr;
+		continue;
+	    }
+	    auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(node))->scan_node(keys[i]);
+	    auto vend = node->get_version(need_restart);
+	    if(need_restart || (vstart != vend)){
+		cur[i] = nullptr;
+		continue;
+	    }
+	    __builtin_prefetch(child);
+	    cur[i] = child;
+	    descending = true;
+	}
+    }
+
+    for(size_t i=0; i<num; i++){
+	if(cur[i])
+	    (static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur[i]))->prefetch(keys[i]);
+    }
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inode_t<Key_t, Geometry_t>** btree_t<Key_t, Value_t, Geometry_t>::new_root_for_adjustment(Key_t* key, node_t** value, int num, int& new_num){
+    int batch_size = inode_t<Key_t, Geometry_t>::cardinality * FILL_FACTOR;
+    if(num % batch_size == 0)
+	new_num = num / batch_size;
+    else
+	new_num = num / batch_size + 1;
+
+    auto new_roots = new inode_t<Key_t, Geometry_t>*[new_num];
+    int idx = 0;
+    for(int i=0; i<new_num; i++){
+	new_roots[i] = new inode_t<Key_t, Geometry_t>(value[0]->level+1); // level
+//	new_roots[i]->batch_insert(key, value, idx, num, batch_size);
+	if(i < new_num-1)
+	    new_roots[i]->sibling_ptr = static_cast<node_t*>(new_roots[i+1]);
+    }
+    return new_roots;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::batch_insert(Key_t* key, node_t** value, int num, node_t* prev, ThreadInfo& threadEpocheInfo){
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto cur = root;
+    bool need_restart = false;
+
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    while(cur->level != prev->level+1){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key[0]);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    // found parent
+    while(cur->sibling_ptr && ((static_cast<inode_t<Key_t, Geometry_t>*>(cur))->high_key < key[0])){
+	auto sibling = cur->sibling_ptr;
+	auto sibling_vstart = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = static_cast<inode_t<Key_t, Geometry_t>*>(sibling);
+	cur_vstart = sibling_vstart;
+    }
+
+    cur->try_upgrade_writelock(cur_vstart, need_restart);
+    if(need_restart)
+	goto restart;
+
+    if(prev->level == 0){
+	value[0]->write_unlock();
+	(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(prev))->convert_unlock_obsolete();
+	drop_tail(static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(prev));
+	threadEpocheInfo.getEpoche().markNodeForDeletion(prev, threadEpocheInfo);
+    }
+    else
+	prev->write_unlock();
+
+    auto parent = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
+    int new_num = 0;
+    inode_t<Key_t, Geometry_t>** new_nodes;
+    if(parent->level == 1)
+	new_nodes = parent->batch_insert_last_level(key, value, num, new_num);
     else
 	new_nodes = parent->batch_insert(key, value, num, new_num);
     delete[] value;
@@ -469,24 +1351,28 @@ void btree_t<Key_t, Value_t>::batch_insert(Key_t* key, node_t** value, int num,
 	batch_insert(split_key, reinterpret_cast<node_t**>(new_nodes), new_num, static_cast<node_t*>(parent), threadEpocheInfo);
     else{ // create new root
 	// TODO: recursive roots
-	while(inode_t<Key_t>::cardinality < new_num){
+	while(inode_t<Key_t, Geometry_t>::cardinality < new_num){
 	    int _new_num = 0;
 	    auto new_roots = new_root_for_adjustment(split_key, reinterpret_cast<node_t**>(new_nodes), new_num, _new_num);
+	    delete[] new_nodes;
 	    new_nodes = new_roots;
 	    new_num = _new_num;
 	}
 
-	auto new_root = new inode_t<Key_t>(new_nodes[0]->level+1);
+	auto new_root = new inode_t<Key_t, Geometry_t>(new_nodes[0]->level+1);
 	new_root->insert_for_root(split_key, reinterpret_cast<node_t**>(new_nodes), static_cast<node_t*>(parent), new_num);
+	delete[] new_nodes;
 	root = new_root;
 	parent->write_unlock();
     }
 }
 
-template <typename Key_t, typename Value_t>
-int btree_t<Key_t, Value_t>::range_lookup(Key_t min_key, int range, Value_t* buf, ThreadInfo& threadEpocheInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::range_lookup(Key_t min_key, int range, Value_t* buf, ThreadInfo& threadEpocheInfo){
     EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
     restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
     auto cur = root;
     bool need_restart = false;
     auto cur_vstart = cur->try_readlock(need_restart);
@@ -495,7 +1381,7 @@ int btree_t<Key_t, Value_t>::range_lookup(Key_t min_key, int range, Value_t* buf
 
     // traversal
     while(cur->level != 0){
-	auto child = (static_cast<inode_t<Key_t>*>(cur))->scan_node(min_key);
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(min_key);
 	auto child_vstart = child->try_readlock(need_restart);
 	if(need_restart)
 	    goto restart;
@@ -510,7 +1396,7 @@ int btree_t<Key_t, Value_t>::range_lookup(Key_t min_key, int range, Value_t* buf
 
     // found leaf
     int count = 0;
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     auto leaf_vstart = cur_vstart;
 
     bool continued = false;
@@ -527,17 +1413,29 @@ int btree_t<Key_t, Value_t>::range_lookup(Key_t min_key, int range, Value_t* buf
 	    if(need_restart || (leaf_vstart != leaf_vend))
 		goto restart;
 
-	    leaf = static_cast<lnode_t<Key_t, Value_t>*>(sibling);
+	    leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
 	    leaf_vstart = sibling_v;
 	}
 
 	auto ret = leaf->range_lookup(min_key, buf, count, range, continued);
 	if(ret == -1)
 	    goto restart;
+	#ifdef ADAPTATION
 	else if(ret == -2){
-	    auto ret_ = convert(leaf, leaf_vstart, threadEpocheInfo);
-	    goto restart;
+	    if(converter && (convert_pending.fetch_add(1) < converter_lag)){ // background converter keeps up, read hash node as is
+		converter_cv.notify_one();
+		ret = (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->range_lookup(min_key, buf, count, range);
+		if(ret == -1)
+		    goto restart;
+	    }
+	    else{
+		if(convert(leaf, leaf_vstart, threadEpocheInfo))
+		    convert_foreground++;
+		conflict(RESTART_CONVERT, nullptr, nullptr, 0);
+		goto restart;
+	    }
 	}
+	#endif
 	continued = true;
 
 	auto sibling = leaf->sibling_ptr;
@@ -556,17 +1454,17 @@ int btree_t<Key_t, Value_t>::range_lookup(Key_t min_key, int range, Value_t* buf
 	if(need_restart)
 	    goto restart;
 
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(sibling);
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
 	leaf_vstart = sibling_vstart;
 	count = ret;
     }
     return count;
 }
 
-template <typename Key_t, typename Value_t>
-bool btree_t<Key_t, Value_t>::convert(lnode_t<Key_t, Value_t>* leaf, uint64_t leaf_version, ThreadInfo& threadEpocheInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::convert(lnode_t<Key_t, Value_t, Geometry_t>* leaf, uint64_t leaf_version, ThreadInfo& threadEpocheInfo){
     int num = 0;
-    auto nodes = (static_cast<lnode_hash_t<Key_t, Value_t>*>(leaf))->convert(num, leaf_version);
+    auto nodes = (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->convert(num, leaf_version);
     if(nodes == nullptr)
 	return false;
 
@@ -580,23 +1478,23 @@ bool btree_t<Key_t, Value_t>::convert(lnode_t<Key_t, Value_t>* leaf, uint64_t le
 }
 
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::convert_all(ThreadInfo& threadEpocheInfo){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::convert_all(ThreadInfo& threadEpocheInfo){
     EpocheGuard epocheGuard(threadEpocheInfo);
     auto cur = root;
     while(cur->level != 0)
 	cur = cur->leftmost_ptr;
 
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     bool need_restart = false;
     auto cur_vstart = cur->get_version(need_restart);
 
     int count = 0;
     do{
-	if(leaf->type == lnode_t<Key_t, Value_t>::BTREE_NODE){
+	if(leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE){
 	    if(!leaf->sibling_ptr)
 		return;
-	    leaf = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr);
+	    leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
 	    continue;
 	}
 
@@ -604,27 +1502,552 @@ void btree_t<Key_t, Value_t>::convert_all(ThreadInfo& threadEpocheInfo){
 	auto ret = convert(leaf, cur_vstart, threadEpocheInfo);
 	if(!ret)
 	    blink_printf("Something wrong!! -- converting leaf %llx failed\n", leaf);
-    }while((leaf = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr)));
+    }while((leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr)));
+}
+
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::start_converter(int lag, int interval_ms){
+    if(converter)
+	return;
+    converter_lag = lag;
+    converter_interval = interval_ms;
+    converter_running = true;
+    converter = new std::thread(&btree_t<Key_t, Value_t, Geometry_t>::background_convert, this);
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::stop_converter(){
+    if(!converter)
+	return;
+    {
+	std::lock_guard<std::mutex> lock(converter_mutex);
+	converter_running = false;
+    }
+    converter_cv.notify_one();
+    converter->join();
+    delete converter;
+    converter = nullptr;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::convert_stats(uint64_t& foreground, uint64_t& background){
+    foreground = convert_foreground.load();
+    background = convert_background.load();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::set_overflow_convert(double min_util){
+    overflow_util = min_util;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::overflow_stats(uint64_t& converted, uint64_t& split){
+    converted = overflow_converted.load();
+    split = overflow_split.load();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::set_merge_threshold(double min_util){
+    merge_threshold = min_util;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::merge_stats(uint64_t& merged, uint64_t& rebalanced){
+    merged = merged_nodes.load();
+    rebalanced = rebalanced_nodes.load();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+uint64_t btree_t<Key_t, Value_t, Geometry_t>::compact(ThreadInfo& threadEpocheInfo){
+    auto merged = merged_nodes.load();
+    Key_t key{};
+    bool first = true;
+    // a step per leaf, so that nodes merged away can be reclaimed while the walk goes on
+    while(compact_step(key, first, threadEpocheInfo));
+    return merged_nodes.load() - merged;
+}
+
+/* one leaf of compact: the leftmost leaf the first time, otherwise the leaf after the one whose high key is key,
+   merged away if it is empty or a btree leaf below the threshold; returns false at the rightmost leaf */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::compact_step(Key_t& key, bool& first, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto cur = root;
+    bool need_restart = false;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    // traversal
+    while(cur->level != 0){
+	auto child = first ? cur->leftmost_ptr : (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+    while(!first && leaf->sibling_ptr && !(key < leaf->high_key)){
+	auto sibling = leaf->sibling_ptr;
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto leaf_vend = leaf->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend))
+	    goto restart;
+
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
+	leaf_vstart = sibling_v;
+    }
+
+    if(!leaf->sibling_ptr)
+	return false;
+    key = leaf->high_key;
+    first = false;
+    auto util = leaf->utilization();
+    if((util == 0) || ((leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) && (util < merge_threshold)))
+	merge_node(key, 0, threadEpocheInfo);
+    return true;
 }
 
+/* merges the node at level covering key with a neighbour under the same parent or evens the two out,
+   every lock is only tried so that a busy neighbourhood is left as it is; returns false if nothing was done */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::merge_node(Key_t key, int level, ThreadInfo& threadEpocheInfo){
+    bool need_restart = false;
+    auto cur = root;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart || (cur->level <= level))
+	return false;
+
+    while(cur->level != level+1){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    return false;
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::print_leaf(){
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    return false;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    auto parent = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
+    while(parent->sibling_ptr && (parent->high_key < key)){
+	auto sibling = parent->sibling_ptr;
+	auto sibling_vstart = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    return false;
+
+	auto parent_vend = parent->get_version(need_restart);
+	if(need_restart || (cur_vstart != parent_vend))
+	    return false;
+
+	parent = static_cast<inode_t<Key_t, Geometry_t>*>(sibling);
+	cur_vstart = sibling_vstart;
+    }
+
+    parent->try_upgrade_writelock(cur_vstart, need_restart);
+    if(need_restart)
+	return false;
+    if(parent->get_cnt() == 0){ // single child, nothing to merge with
+	parent->write_unlock();
+	return false;
+    }
+
+    // the leftmost child pairs with its right neighbour, any other child with its left one
+    int pos = std::max(parent->find_lowerbound(key), 0);
+    int ret = (level == 0) ? merge_leaves(parent, pos, threadEpocheInfo) : merge_inodes(parent, pos, threadEpocheInfo);
+    if(ret == 2) // parent was the root and has been retired
+	return true;
+
+    // a parent down to a single child is merged even when the threshold is off
+    bool underfull = (ret == 1) && (parent != root) && ((parent->get_cnt() == 0) || (parent->get_cnt() < inode_t<Key_t, Geometry_t>::cardinality * merge_threshold));
+    parent->write_unlock();
+    if(underfull)
+	merge_node(key, level+1, threadEpocheInfo);
+    return (ret != -1);
+}
+
+/* merges child pos of parent into child pos-1, with parent write-locked;
+   returns 1 if the right one was retired, 0 if the two were evened out and -1 otherwise */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::merge_leaves(inode_t<Key_t, Geometry_t>* parent, int pos, ThreadInfo& threadEpocheInfo){
+    auto left = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(parent->child(pos-1));
+    auto right = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(parent->child(pos));
+    if(right->sibling_ptr == nullptr) // the rightmost leaf takes the inserts, it stays
+	return -1;
+    if((right->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) && (right->utilization() != 0))
+	return -1; // hash leaves only give way when empty, no point in locking every bucket
+
+    if(!lock_for_merge(left, false))
+	return -1;
+    if(!lock_for_merge(right, true)){
+	unlock_for_merge(left, false, false);
+	return -1;
+    }
+
+    Key_t separator;
+    int ret = (left->sibling_ptr == right) ? left->merge(right, merge_threshold, separator) : -1;
+    if(ret == 1){
+	left->high_key = right->high_key;
+	left->sibling_ptr = right->sibling_ptr;
+	auto next = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(right->sibling_ptr);
+	if(next->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) // right held the lock that guards it
+	    (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(next))->left_sibling_ptr = reinterpret_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(left);
+	parent->remove_at(pos);
+	unlock_for_merge(right, true, true);
+	drop_tail(right);
+	threadEpocheInfo.getEpoche().markNodeForDeletion(right, threadEpocheInfo);
+	merged_nodes.fetch_add(1, std::memory_order_relaxed);
+    }
+    else{
+	if(ret == 0){
+	    parent->set_separator(pos, separator);
+	    rebalanced_nodes.fetch_add(1, std::memory_order_relaxed);
+	}
+	unlock_for_merge(right, true, false);
+    }
+    unlock_for_merge(left, false, false);
+    return ret;
+}
+
+/* as merge_leaves for inner nodes; returns 2 if parent was the root and left took its place */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::merge_inodes(inode_t<Key_t, Geometry_t>* parent, int pos, ThreadInfo& threadEpocheInfo){
+    auto left = static_cast<inode_t<Key_t, Geometry_t>*>(parent->child(pos-1));
+    auto right = static_cast<inode_t<Key_t, Geometry_t>*>(parent->child(pos));
+    if(!left->try_writelock())
+	return -1;
+    if(!right->try_writelock()){
+	left->write_unlock();
+	return -1;
+    }
+
+    int ret = -1;
+    if(left->sibling_ptr == right){
+	int min_cnt = inode_t<Key_t, Geometry_t>::cardinality * merge_threshold;
+	if(left->merge(right, parent->separator(pos)))
+	    ret = 1;
+	else if((left->get_cnt() < min_cnt) || (right->get_cnt() < min_cnt)){
+	    parent->set_separator(pos, left->rebalance(right, parent->separator(pos)));
+	    ret = 0;
+	}
+    }
+
+    if(ret == 1){
+	parent->remove_at(pos);
+	right->write_unlock_obsolete();
+	threadEpocheInfo.getEpoche().markNodeForDeletion(right, threadEpocheInfo);
+	merged_nodes.fetch_add(1, std::memory_order_relaxed);
+	if((parent == root) && (parent->get_cnt() == 0)){ // left is the only child left, it becomes the root
+	    root = static_cast<node_t*>(left);
+	    parent->write_unlock_obsolete();
+	    threadEpocheInfo.getEpoche().markNodeForDeletion(parent, threadEpocheInfo);
+	    merged_nodes.fetch_add(1, std::memory_order_relaxed);
+	    ret = 2;
+	}
+    }
+    else{
+	if(ret == 0)
+	    rebalanced_nodes.fetch_add(1, std::memory_order_relaxed);
+	right->write_unlock();
+    }
+    left->write_unlock();
+    return ret;
+}
+
+/* whole locks every bucket of a hash leaf as a split does, after migrating the buckets linked to its neighbours;
+   otherwise the node lock alone keeps writers out */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::lock_for_merge(lnode_t<Key_t, Value_t, Geometry_t>* leaf, bool whole){
+    if(whole && (leaf->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)){
+	bool need_restart = false;
+	auto version = leaf->get_version(need_restart);
+	if(need_restart)
+	    return false;
+	auto hleaf = static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf);
+	#ifdef LINKED
+	if(!hleaf->stabilize_all(version))
+	    return false;
+	#endif
+	return hleaf->try_splitlock(version);
+    }
+    return (static_cast<node_t*>(leaf))->try_writelock();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::unlock_for_merge(lnode_t<Key_t, Value_t, Geometry_t>* leaf, bool whole, bool obsolete){
+    if(whole && (leaf->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE)){
+	auto hleaf = static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf);
+	if(obsolete)
+	    hleaf->split_unlock_obsolete();
+	else
+	    hleaf->split_unlock();
+    }
+    else if(obsolete)
+	(static_cast<node_t*>(leaf))->write_unlock_obsolete();
+    else
+	(static_cast<node_t*>(leaf))->write_unlock();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::restart_stats(uint64_t* count){
+    #if defined(BREAKDOWN) || defined(BACKOFF)
+    auto& stats = thread_restarts();
+    for(int i=0; i<RESTART_CAUSES; i++)
+	count[i] = stats.count[i];
+    #else
+    std::fill(count, count + RESTART_CAUSES, 0);
+    #endif
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::split_stats(uint64_t& leaf, uint64_t& inner){
+    leaf = leaf_splits.load();
+    inner = inner_splits.load();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::start_sweeper(int interval_ms){
+    #ifdef LINKED
+    if(sweeper)
+	return;
+    sweeper_interval = interval_ms;
+    sweeper_running = true;
+    sweeper = new std::thread(&btree_t<Key_t, Value_t, Geometry_t>::background_sweep, this);
+    #endif
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::stop_sweeper(){
+    if(!sweeper)
+	return;
+    {
+	std::lock_guard<std::mutex> lock(sweeper_mutex);
+	sweeper_running = false;
+    }
+    sweeper_cv.notify_one();
+    sweeper->join();
+    delete sweeper;
+    sweeper = nullptr;
+    sweep_queue.clear();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::sweep_stats(uint64_t& swept, uint64_t& missed){
+    swept = sweep_done.load();
+    missed = sweep_missed.load();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::queue_sweep(Key_t split_key){
+    std::lock_guard<std::mutex> lock(sweeper_mutex);
+    sweep_queue.push_back(split_key);
+}
+
+/* picks up the leaves split in the last interval, by then their splitters have mostly unlocked them */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::background_sweep(){
+    auto threadEpocheInfo = attach_thread();
+    std::vector<Key_t> keys;
+    while(sweeper_running){
+	{
+	    std::unique_lock<std::mutex> lock(sweeper_mutex);
+	    sweeper_cv.wait_for(lock, std::chrono::milliseconds(sweeper_interval), [this]{ return !sweeper_running; });
+	    keys.swap(sweep_queue);
+	}
+	for(auto key: keys){
+	    if(!sweeper_running)
+		break;
+	    if(sweep_leaf(key, *threadEpocheInfo))
+		sweep_done++;
+	    else
+		sweep_missed++;
+	}
+	keys.clear();
+    }
+    detach_thread(threadEpocheInfo);
+}
+
+/* the leaf holding key is the left half of a split, stabilizing it also stabilizes its new sibling */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::sweep_leaf(Key_t key, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto cur = root;
+    bool need_restart = false;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    // traversal
+    while(cur->level != 0){
+	auto child = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+    while(leaf->sibling_ptr && (leaf->high_key < key)){
+	auto sibling = leaf->sibling_ptr;
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart) goto restart;
+
+	auto leaf_vend = leaf->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend)) goto restart;
+
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
+	leaf_vstart = sibling_v;
+    }
+
+    if(leaf->type != lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE) // converted, which stabilized it
+	return true;
+    return (static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->stabilize_all(leaf_vstart);
+}
+
+/* converts hash nodes behind the rightmost leaf in the background,
+   scans wake it up whenever they read an unconverted hash node */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::background_convert(){
+    auto threadEpocheInfo = attach_thread();
+    Key_t sweep_key{};
+    bool from_leftmost = true;
+    while(converter_running){
+	convert_pending = 0;
+	if(convert_sweep(sweep_key, from_leftmost, *threadEpocheInfo) == 0){
+	    std::unique_lock<std::mutex> lock(converter_mutex);
+	    converter_cv.wait_for(lock, std::chrono::milliseconds(converter_interval), [this]{
+		    return !converter_running || (convert_pending > 0);
+		    });
+	}
+    }
+    detach_thread(threadEpocheInfo);
+}
+
+/* hash nodes only come from splitting hash nodes, so every hash node lies to the right of
+   the leftmost one left unconverted and the next sweep can start from there */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+int btree_t<Key_t, Value_t, Geometry_t>::convert_sweep(Key_t& sweep_key, bool& from_leftmost, ThreadInfo& threadEpocheInfo){
+    Key_t key = sweep_key;
+    bool first = from_leftmost;
+    bool skipped = false;
+    int converted = 0;
+    // each step enters the epoch on its own and only carries the key over, so converted leaves can be reclaimed meanwhile
+    while(converter_running && convert_step(key, first, converted, skipped, threadEpocheInfo)){
+	if(!skipped){
+	    sweep_key = key;
+	    from_leftmost = false;
+	}
+    }
+    return converted;
+}
+
+/* converts the leaf right of key, the high key of the last leaf visited, or the leftmost leaf the first time,
+   if it is a hash leaf; returns false once the rightmost leaf, which is left as it is, is reached */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+bool btree_t<Key_t, Value_t, Geometry_t>::convert_step(Key_t& key, bool& first, int& converted, bool& skipped, ThreadInfo& threadEpocheInfo){
+    EpocheGuard epocheGuard(threadEpocheInfo);
+    backoff_t backoff;
+    restart:
+    backoff.restart(restart_cause<Key_t, Value_t, Geometry_t>);
+    auto cur = root;
+    bool need_restart = false;
+    auto cur_vstart = cur->try_readlock(need_restart);
+    if(need_restart)
+	goto restart;
+
+    // traversal
+    while(cur->level != 0){
+	auto child = first ? cur->leftmost_ptr : (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->scan_node(key);
+	auto child_vstart = child->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto cur_vend = cur->get_version(need_restart);
+	if(need_restart || (cur_vstart != cur_vend))
+	    goto restart;
+
+	cur = child;
+	cur_vstart = child_vstart;
+    }
+
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    auto leaf_vstart = cur_vstart;
+    while(!first && leaf->sibling_ptr && !(key < leaf->high_key)){
+	auto sibling = leaf->sibling_ptr;
+	auto sibling_v = sibling->try_readlock(need_restart);
+	if(need_restart)
+	    goto restart;
+
+	auto leaf_vend = leaf->get_version(need_restart);
+	if(need_restart || (leaf_vstart != leaf_vend))
+	    goto restart;
+
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(sibling);
+	leaf_vstart = sibling_v;
+    }
+
+    if(!leaf->sibling_ptr)
+	return false;
+    if(leaf->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE){
+	need_restart = false;
+	leaf_vstart = leaf->get_version(need_restart);
+	if(!need_restart && convert(leaf, leaf_vstart, threadEpocheInfo)){
+	    converted++;
+	    convert_background++;
+	}
+	else // locked by writers, try again in the next sweep
+	    skipped = true;
+    }
+    key = leaf->high_key;
+    first = false;
+    return true;
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::print_leaf(){
     auto cur = root;
     while(cur->level != 0)
 	cur = cur->leftmost_ptr;
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     int cnt = 1;
     do{
 	std::cout << "L" << cnt << "(" << leaf << ": ";
 	leaf->print();
 	cnt++;
-    }while((leaf = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr)));
+    }while((leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr)));
 }
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::print_internal(){
-    auto cur = static_cast<inode_t<Key_t>*>(root);
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::print_internal(){
+    auto cur = static_cast<inode_t<Key_t, Geometry_t>*>(root);
     auto internal = cur;
     int level = 0;
     int cnt = 1;
@@ -635,45 +2058,45 @@ void btree_t<Key_t, Value_t>::print_internal(){
 	    std::cout << "I" << cnt << "(" << cur << "): ";
 	    cur->print();
 	    cnt++;
-	}while((cur = static_cast<inode_t<Key_t>*>(cur->sibling_ptr)));
+	}while((cur = static_cast<inode_t<Key_t, Geometry_t>*>(cur->sibling_ptr)));
 	level++;
 	cur = internal;
-	cur = static_cast<inode_t<Key_t>*>(cur->leftmost_ptr);
+	cur = static_cast<inode_t<Key_t, Geometry_t>*>(cur->leftmost_ptr);
     }
 }
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::print(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::print(){
     print_internal();
     print_leaf();
 }
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::sanity_check(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::sanity_check(){
     auto cur = root;
     while(cur->level != 0){
-	auto p = static_cast<inode_t<Key_t>*>(cur);
+	auto p = static_cast<inode_t<Key_t, Geometry_t>*>(cur);
 	p->sanity_check(p->high_key, true);
 	cur = cur->leftmost_ptr;
     }
 
-    auto l = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto l = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     l->sanity_check(l->high_key, true);
 }
 
 
-template <typename Key_t, typename Value_t>
-Value_t btree_t<Key_t, Value_t>::find_anyway(Key_t key){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+Value_t btree_t<Key_t, Value_t, Geometry_t>::find_anyway(Key_t key){
     auto cur = root;
     while(cur->level != 0)
 	cur = cur->leftmost_ptr;
 
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
-    lnode_t<Key_t, Value_t>* before;
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    lnode_t<Key_t, Value_t, Geometry_t>* before;
     do{
 	bool need_restart = false;
-	auto ret = leaf->find(key, need_restart);
-	if(ret){
+	Value_t ret;
+	if(leaf->find(key, ret, need_restart)){
 	    std::cout << "before node(" << before << ")" << std::endl;
 	    before->print();
 	    std::cout << "current node(" << leaf << ")" << std::endl;
@@ -681,21 +2104,21 @@ Value_t btree_t<Key_t, Value_t>::find_anyway(Key_t key){
 	    return ret;
 	}
 	before = leaf;
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr);
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
     }while(leaf);
 
     return 0;
 }
 
-template <typename Key_t, typename Value_t>
-double btree_t<Key_t, Value_t>::utilization(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double btree_t<Key_t, Value_t, Geometry_t>::utilization(){
     auto cur = root;
     auto node = cur;
     while(cur->level != 0){
 	uint64_t total = 0;
 	uint64_t count = 0;
 	while(node){
-	    total += inode_t<Key_t>::cardinality;
+	    total += inode_t<Key_t, Geometry_t>::cardinality;
 	    count += node->get_cnt();
 	    node = node->sibling_ptr;
 	}
@@ -704,42 +2127,39 @@ double btree_t<Key_t, Value_t>::utilization(){
 	node = cur;
     }
 
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     int leaf_cnt = 0;
     double util = 0;
     do{
 	leaf_cnt++;
 	util += leaf->utilization();
 
-	leaf = static_cast<lnode_t<Key_t, Value_t>*>(leaf->sibling_ptr);
+	leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
     }while(leaf);
     std::cout << "leaf " << (double)util/leaf_cnt*100.0 << " \%" << std::endl;
     return util/leaf_cnt*100.0;
 }
 
-template <typename Key_t, typename Value_t>
-double btree_t<Key_t, Value_t>::rightmost_utilization(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+double btree_t<Key_t, Value_t, Geometry_t>::rightmost_utilization(){
     auto cur = root;
     auto node = cur;
     while(cur->level != 0)
-	cur = (static_cast<inode_t<Key_t>*>(cur))->rightmost_ptr();
+	cur = (static_cast<inode_t<Key_t, Geometry_t>*>(cur))->rightmost_ptr();
 
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
-    if(leaf->type == lnode_t<Key_t, Value_t>::HASH_NODE){
-	auto util = (double)(static_cast<lnode_hash_t<Key_t, Value_t>*>(leaf))->utilization() * 100;
-	return util;
-    }
-    else{
-	auto cnt = (static_cast<lnode_btree_t<Key_t, Value_t>*>(leaf))->get_cnt();
-	auto util = (double)cnt / lnode_btree_t<Key_t, Value_t>::cardinality * 100;
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
+    if(leaf->type == lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE){
+	auto util = (double)(static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf))->utilization() * 100;
 	return util;
     }
+    else
+	return leaf->utilization() * 100;
     return 0;
 }
 
 
-template <typename Key_t, typename Value_t>
-void btree_t<Key_t, Value_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied){
     auto cur = root;
     auto leftmost_node = cur;
     while(cur->level != 0){
@@ -747,43 +2167,119 @@ void btree_t<Key_t, Value_t>::footprint(uint64_t& meta, uint64_t& structural_dat
 	do{
 	    meta += sizeof(node_t) + sizeof(Key_t) - sizeof(node_t*);
 	    auto cnt = cur->get_cnt();
-	    auto invalid_num = inode_t<Key_t>::cardinality - cnt;
+	    auto invalid_num = inode_t<Key_t, Geometry_t>::cardinality - cnt;
 	    structural_data_occupied += sizeof(entry_t<Key_t, node_t*>)*cnt + sizeof(node_t*);
 	    structural_data_unoccupied += sizeof(entry_t<Key_t, node_t*>)*invalid_num;
-	    cur = static_cast<node_t*>((static_cast<inode_t<Key_t>*>(cur))->sibling_ptr);
+	    cur = static_cast<node_t*>((static_cast<inode_t<Key_t, Geometry_t>*>(cur))->sibling_ptr);
 	}while(cur);
-	cur = (static_cast<inode_t<Key_t>*>(leftmost_node))->leftmost_ptr;
+	cur = (static_cast<inode_t<Key_t, Geometry_t>*>(leftmost_node))->leftmost_ptr;
     }
 
-    auto leaf = static_cast<lnode_t<Key_t, Value_t>*>(cur);
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(cur);
     do{
-	meta += sizeof(lnode_t<Key_t, Value_t>);
+	meta += sizeof(lnode_t<Key_t, Value_t, Geometry_t>);
 	auto type = leaf->type;
-	if(type == lnode_t<Key_t, Value_t>::BTREE_NODE){
-	    auto lnode = static_cast<lnode_btree_t<Key_t, Value_t>*>(leaf);
+	if(type == lnode_t<Key_t, Value_t, Geometry_t>::BTREE_NODE){
+	    auto lnode = static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(leaf);
 	    auto cnt = lnode->get_cnt();
-	    auto invalid_num = lnode_btree_t<Key_t, Value_t>::cardinality - cnt;
+	    auto invalid_num = lnode_btree_t<Key_t, Value_t, Geometry_t>::cardinality - cnt;
 	    key_data_occupied += sizeof(entry_t<Key_t, Value_t>)*cnt;
 	    key_data_unoccupied += sizeof(entry_t<Key_t, Value_t>)*invalid_num;
-	    leaf = static_cast<lnode_t<Key_t, Value_t>*>(lnode->sibling_ptr);
+	    leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(lnode->sibling_ptr);
+	}
+	else if(type == lnode_t<Key_t, Value_t, Geometry_t>::DELTA_NODE){
+	    if constexpr(key_traits_t<Key_t>::delta){
+		auto lnode = static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(leaf);
+		lnode->footprint(meta, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied);
+	    }
+	    leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(leaf->sibling_ptr);
 	}
 	else{
-	    auto lnode = static_cast<lnode_hash_t<Key_t, Value_t>*>(leaf);
+	    auto lnode = static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf);
 	    lnode->footprint(meta, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied);
-	    leaf = static_cast<lnode_t<Key_t, Value_t>*>(lnode->sibling_ptr);
+	    leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(lnode->sibling_ptr);
 	}
     }while(leaf);
+    key_data_occupied += arena.size();
+}
+
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied, uint64_t& pool_live, uint64_t& pool_free){
+    footprint(meta, structural_data_occupied, structural_data_unoccupied, key_data_occupied, key_data_unoccupied);
+    pool_live = pool_free = 0;
+    #ifdef NODE_POOL
+    uint64_t live, pooled;
+    node_pool_t<lnode_hash_t<Key_t, Value_t, Geometry_t>>::footprint(live, pooled);
+    pool_live += live;
+    pool_free += pooled;
+    node_pool_t<lnode_btree_t<Key_t, Value_t, Geometry_t>>::footprint(live, pooled);
+    pool_live += live;
+    pool_free += pooled;
+    if constexpr(key_traits_t<Key_t>::delta){
+	node_pool_t<lnode_delta_t<Key_t, Value_t, Geometry_t>>::footprint(live, pooled);
+	pool_live += live;
+	pool_free += pooled;
+    }
+    #endif
+}
+
+/* retired nodes are freed through their own type so that pooled leaves return to the pool */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::delete_node(void* node){
+    auto n = static_cast<node_t*>(node);
+    if(n->level != 0){
+	delete static_cast<inode_t<Key_t, Geometry_t>*>(n);
+	return;
+    }
+
+    auto leaf = static_cast<lnode_t<Key_t, Value_t, Geometry_t>*>(n);
+    switch(leaf->type){
+	case lnode_t<Key_t, Value_t, Geometry_t>::BTREE_NODE:
+	    delete static_cast<lnode_btree_t<Key_t, Value_t, Geometry_t>*>(leaf);
+	    return;
+	case lnode_t<Key_t, Value_t, Geometry_t>::DELTA_NODE:
+	    if constexpr(key_traits_t<Key_t>::delta)
+		delete static_cast<lnode_delta_t<Key_t, Value_t, Geometry_t>*>(leaf);
+	    return;
+	case lnode_t<Key_t, Value_t, Geometry_t>::HASH_NODE:
+	    delete static_cast<lnode_hash_t<Key_t, Value_t, Geometry_t>*>(leaf);
+	    return;
+	default:
+	    std::cerr << __func__ << ": node type error: " << leaf->type << std::endl;
+	    return;
+    }
 }
 
-template <typename Key_t, typename Value_t>
-inline int btree_t<Key_t, Value_t>::height(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline int btree_t<Key_t, Value_t, Geometry_t>::height(){
     return root->level;
 }
 
-template <typename Key_t, typename Value_t>
-inline ThreadInfo btree_t<Key_t, Value_t>::getThreadInfo(){
+template <typename Key_t, typename Value_t, typename Geometry_t>
+inline ThreadInfo btree_t<Key_t, Value_t, Geometry_t>::getThreadInfo(){
     return ThreadInfo(this->epoche);
 }
 
-template class btree_t<key64_t, value64_t>;
+/* registers the calling thread once and returns a handle that can be reused
+   across operations, instead of looking up the deletion list on every call */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+ThreadInfo* btree_t<Key_t, Value_t, Geometry_t>::attach_thread(){
+    return new ThreadInfo(this->epoche);
+}
+
+/* reclaims what the thread retired before releasing its handle,
+   otherwise nodes below the gc threshold stay in its deletion list until teardown */
+template <typename Key_t, typename Value_t, typename Geometry_t>
+void btree_t<Key_t, Value_t, Geometry_t>::detach_thread(ThreadInfo* threadEpocheInfo){
+    epoche.cleanup(*threadEpocheInfo);
+    delete threadEpocheInfo;
+}
+
+template class btree_t<key64_t, value64_t, default_geometry_t>;
+template class btree_t<key64_t, value64_t, leaf_64k_geometry_t>;
+template class btree_t<key64_t, value64_t, leaf_1m_geometry_t>;
+template class btree_t<key64_t, value64_t, page_1k_geometry_t>;
+template class btree_t<key64_t, value64_t, slot_8_geometry_t>;
+
+template class btree_t<string_key_t, value64_t, default_geometry_t>;
 }
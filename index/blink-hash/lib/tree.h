@@ -5,10 +5,29 @@
 #include "lnode.h"
 #include "Epoche.h"
 #include "Epoche.cpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 namespace BLINK_HASH{
 
-template <typename Key_t, typename Value_t>
+/* on-disk layout of btree_t::checkpoint(): this header followed by num entries sorted by key */
+struct checkpoint_header_t{
+    static constexpr uint32_t current_version = 1;
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t reserved;
+    uint64_t num;
+};
+
+template <typename Key_t, typename Value_t, typename Geometry_t = default_geometry_t>
 class btree_t{
     public:
 	inline uint64_t _rdtsc(){
@@ -23,17 +42,19 @@ class btree_t{
 	    #endif
 	}
 
-	btree_t(){ 
-	    root = static_cast<node_t*>(new lnode_hash_t<Key_t, Value_t>());
-	    #ifndef FINGERPRINT
-	    memset(&EMPTY<Key_t>, 0, sizeof(EMPTY<Key_t>));
-	    #endif
-	}
-	~btree_t(){ }
+	btree_t();
+	~btree_t();
 
 	int check_height();
 
 	void insert(Key_t key, Value_t value, ThreadInfo& threadEpocheInfo);
+
+	void insert_batch(const entry_t<Key_t, Value_t>* buf, size_t num, ThreadInfo& threadEpocheInfo);
+
+	/* builds an empty tree bottom-up from num entries sorted by unique key: btree leaves filled to fill of their capacity
+	   and inner levels packed the same way, num_threads threads building each level; an empty hash leaf is left
+	   rightmost for the keys that follow, returns false (leaving the tree as is) if the tree is not empty */
+	bool bulk_load(const entry_t<Key_t, Value_t>* sorted, size_t num, double fill=FILL_FACTOR, int num_threads=1);
 	/* this function is called when root has been split by another threads */
 	void insert_key(Key_t key, node_t* value, node_t* prev);
 
@@ -41,12 +62,87 @@ class btree_t{
 
 	bool remove(Key_t key, ThreadInfo& threadEpocheInfo);
 
+	/* removes every key in [lo, hi]: leaves lying inside the range are unlinked and retired a run per parent,
+	   only the leaves at either end lose their keys one by one; returns the number of keys removed */
+	uint64_t remove_range(Key_t lo, Key_t hi, ThreadInfo& threadEpocheInfo);
+
+	/* writes the keys to path in key order while writers go on: each leaf is copied whole under its split lock,
+	   keys written into leaves the walk has passed or beyond the largest key at the start may be left out;
+	   the file is replaced only once complete; keys that are not flat (see key_traits_t) are not supported */
+	bool checkpoint(const char* path, ThreadInfo& threadEpocheInfo);
+
+	/* maps a file written by checkpoint and bulk loads this empty tree from it, returns false if either does not fit */
+	bool restore(const char* path, int num_threads=1);
+
+	bool lookup(Key_t key, Value_t& value, ThreadInfo& threadEpocheInfo);
+
+	/* returns 0 for a missing key as well; use the overload above to tell them apart */
 	Value_t lookup(Key_t key, ThreadInfo& threadEpocheInfo);
 
+	/* found[i] tells whether keys[i] exists; the paths of a group of keys are prefetched before probing them */
+	void lookup_batch(const Key_t* keys, Value_t* values, bool* found, size_t num, ThreadInfo& threadEpocheInfo);
+
 	int range_lookup(Key_t min_key, int range, Value_t* buf, ThreadInfo& threadEpocheInfo);
 
 	void convert_all(ThreadInfo& threadEpocheInfo);
 
+	/* lag: number of unconverted leaves scans may read before converting inline */
+	void start_converter(int lag=64, int interval_ms=10);
+
+	void stop_converter();
+
+	void convert_stats(uint64_t& foreground, uint64_t& background);
+
+	/* migrates the buckets a leaf split left linked to the new sibling in the background,
+	   instead of on first touch or before the leaf splits again (LINKED builds only) */
+	void start_sweeper(int interval_ms=1);
+
+	void stop_sweeper();
+
+	/* split leaves the sweeper stabilized, and those it left to first touch because they were locked or split again */
+	void sweep_stats(uint64_t& swept, uint64_t& missed);
+
+	/* restarts the calling thread has made so far by cause (restart_cause_t), count needs RESTART_CAUSES entries;
+	   only counted in BREAKDOWN and BACKOFF builds, zero otherwise; BACKOFF builds back off before each of them (see backoff_t) */
+	void restart_stats(uint64_t* count);
+
+	/* number of leaf and inner node splits so far */
+	void split_stats(uint64_t& leaf, uint64_t& inner);
+
+	static constexpr int split_stall_buckets = 40;
+
+	/* hist[i]: leaf splits that took [2^i, 2^(i+1)) cycles, hist needs split_stall_buckets entries */
+	void split_stall_stats(uint64_t* hist);
+
+	/* inserts beyond the low key of the cached rightmost leaf skip the traversal (on by default) */
+	void set_tail_cache(bool enable);
+
+	/* a full hash leaf other than the rightmost one is converted to btree leaves instead of split
+	   when at least min_util of its slots are used (0 always splits, the default) */
+	void set_overflow_convert(double min_util);
+
+	/* full hash leaves other than the rightmost one that were converted and that were split */
+	void overflow_stats(uint64_t& converted, uint64_t& split);
+
+	/* a remove that leaves a btree leaf below min_util of its capacity merges it into a neighbour or evens the two out,
+	   inner nodes losing children follow in turn (0.25 by default, 0 disables it) */
+	void set_merge_threshold(double min_util);
+
+	/* walks the leaves once and merges away empty hash leaves and underfull btree leaves, as remove does for the latter;
+	   the rightmost leaf is always kept, returns the number of nodes retired */
+	uint64_t compact(ThreadInfo& threadEpocheInfo);
+
+	/* nodes merged into a neighbour and retired, and pairs evened out instead */
+	void merge_stats(uint64_t& merged, uint64_t& rebalanced);
+
+	#ifdef BREAKDOWN
+	/* cycles the calling thread spent in insert, latch and consolidation are always 0 */
+	void get_breakdown(uint64_t& time_traversal, uint64_t& time_abort, uint64_t& time_latch, uint64_t& time_node, uint64_t& time_split, uint64_t& time_consolidation);
+
+	/* inserts of the calling thread and inner nodes they read on the way down, restarts included */
+	void insert_traversal_stats(uint64_t& inserts, uint64_t& inner_reads);
+	#endif
+
 	void print_leaf();
 
 	void print_internal();
@@ -65,17 +161,107 @@ class btree_t{
 	
 	ThreadInfo getThreadInfo();
 
+	ThreadInfo* attach_thread();
+
+	void detach_thread(ThreadInfo* threadEpocheInfo);
+
 	void footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied);
 
+	/* additionally reports leaf memory handed out by the node pool (live) and kept in it (pooled) */
+	void footprint(uint64_t& meta, uint64_t& structural_data_occupied, uint64_t& structural_data_unoccupied, uint64_t& key_data_occupied, uint64_t& key_data_unoccupied, uint64_t& pool_live, uint64_t& pool_free);
+
     private:
 	node_t* root;
-	Epoche epoche{256};
+	Epoche epoche{256, &btree_t<Key_t, Value_t, Geometry_t>::delete_node};
+
+	std::thread* converter = nullptr;
+	std::atomic<bool> converter_running{false};
+	std::mutex converter_mutex;
+	std::condition_variable converter_cv;
+	std::atomic<int> convert_pending{0};
+	int converter_lag;
+	int converter_interval;
+	std::atomic<uint64_t> convert_foreground{0};
+	std::atomic<uint64_t> convert_background{0};
+	std::thread* sweeper = nullptr;
+	std::atomic<bool> sweeper_running{false};
+	int sweeper_interval;
+	std::mutex sweeper_mutex;
+	std::condition_variable sweeper_cv;
+	std::vector<Key_t> sweep_queue; // split keys of leaves with linked buckets
+	std::atomic<uint64_t> sweep_done{0};
+	std::atomic<uint64_t> sweep_missed{0};
+	std::atomic<uint64_t> leaf_splits{0};
+	std::atomic<uint64_t> inner_splits{0};
+	std::atomic<uint64_t> split_stall[split_stall_buckets] = {};
+	double overflow_util = 0;
+	std::atomic<uint64_t> overflow_converted{0};
+	std::atomic<uint64_t> overflow_split{0};
+	double merge_threshold = 0.25;
+	std::atomic<uint64_t> merged_nodes{0};
+	std::atomic<uint64_t> rebalanced_nodes{0};
+	key_arena_t arena; // bytes of keys that are not flat, kept until the tree is destroyed
+
+	// rightmost leaf and the key it was split off at, guarded by tail_seq (odd while being written)
+	bool tail_enabled = true;
+	std::atomic<uint64_t> tail_seq{0};
+	lnode_t<Key_t, Value_t, Geometry_t>* tail_leaf = nullptr;
+	Key_t tail_low{};
+
+	void split_done(uint64_t split_start);
+
+	bool insert_tail(Key_t key, Value_t value);
+
+	uint64_t tail_writelock();
+
+	void set_tail(lnode_t<Key_t, Value_t, Geometry_t>* leaf, Key_t low_key);
+
+	void drop_tail(lnode_t<Key_t, Value_t, Geometry_t>* leaf);
+
+	bool insert_leaf_batch(entry_t<Key_t, Value_t>* buf, size_t& idx, size_t num, ThreadInfo& threadEpocheInfo);
+
+	bool convert(lnode_t<Key_t, Value_t, Geometry_t>* leaf, uint64_t version, ThreadInfo& threadEpocheInfo);
+
+	void prefetch_path(const Key_t* keys, size_t num);
+
+	static void delete_node(void* node);
+
+	void background_convert();
+
+	int convert_sweep(Key_t& sweep_key, bool& from_leftmost, ThreadInfo& threadEpocheInfo);
+
+	bool convert_step(Key_t& key, bool& first, int& converted, bool& skipped, ThreadInfo& threadEpocheInfo);
+
+	void queue_sweep(Key_t split_key);
+
+	void background_sweep();
+
+	bool sweep_leaf(Key_t key, ThreadInfo& threadEpocheInfo);
+
+	bool merge_node(Key_t key, int level, ThreadInfo& threadEpocheInfo);
+
+	int merge_leaves(inode_t<Key_t, Geometry_t>* parent, int pos, ThreadInfo& threadEpocheInfo);
+
+	int merge_inodes(inode_t<Key_t, Geometry_t>* parent, int pos, ThreadInfo& threadEpocheInfo);
+
+	bool compact_step(Key_t& key, bool& first, ThreadInfo& threadEpocheInfo);
+
+	int remove_range_step(Key_t& key, bool& first, Key_t lo, Key_t hi, uint64_t& removed, std::vector<Key_t>& underfull, ThreadInfo& threadEpocheInfo);
+
+	// checkpoint stops at the leaf holding stop_key, at the leaf above stop_key, or after the first leaf
+	enum checkpoint_stop_t{STOP_AT_KEY, STOP_ABOVE_KEY, STOP_FIRST_LEAF};
+
+	bool checkpoint_bound(Key_t& stop_key, checkpoint_stop_t& stop, entry_t<Key_t, Value_t>* buf, ThreadInfo& threadEpocheInfo);
+
+	int checkpoint_step(Key_t& key, bool& first, Key_t stop_key, checkpoint_stop_t stop, FILE* fp, entry_t<Key_t, Value_t>* buf, uint64_t& num, ThreadInfo& threadEpocheInfo);
+
+	bool lock_for_merge(lnode_t<Key_t, Value_t, Geometry_t>* leaf, bool whole);
 
-	bool convert(lnode_t<Key_t, Value_t>* leaf, uint64_t version, ThreadInfo& threadEpocheInfo);
+	void unlock_for_merge(lnode_t<Key_t, Value_t, Geometry_t>* leaf, bool whole, bool obsolete);
 	
 	void batch_insert(Key_t* key, node_t** value, int num, node_t* prev, ThreadInfo& threadEpocheInfo);
 
-	inode_t<Key_t>** new_root_for_adjustment(Key_t* key, node_t** value, int num, int& new_num);
+	inode_t<Key_t, Geometry_t>** new_root_for_adjustment(Key_t* key, node_t** value, int num, int& new_num);
 };
 }
 #endif
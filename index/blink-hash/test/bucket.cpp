@@ -0,0 +1,128 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <immintrin.h>
+
+#include "bucket.h"
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+using bucket = bucket_t<Key_t, Value_t, 32>;
+
+/* bucket find/insert/collect cost of the fingerprint mode this binary is built with;
+   the AVX_512 build repeats the run for every compare path the CPU supports */
+
+#ifdef AVX_256
+using fingerprint_t = __m256i;
+inline fingerprint_t splat(uint8_t f){ return _mm256_set1_epi8(f); }
+static const char* variant = "AVX_256";
+#elif defined AVX_128
+using fingerprint_t = __m128i;
+inline fingerprint_t splat(uint8_t f){ return _mm_set1_epi8(f); }
+static const char* variant = "AVX_128";
+#elif defined AVX_512
+using fingerprint_t = uint8_t;
+inline fingerprint_t splat(uint8_t f){ return f; }
+static const char* variant = "AVX_512";
+#else
+using fingerprint_t = uint8_t;
+inline fingerprint_t splat(uint8_t f){ return f; }
+static const char* variant = "scalar";
+#endif
+
+inline uint8_t fingerprint_of(Key_t key){
+    return ((key * 0x9E3779B97F4A7C15ULL) >> 56) | 1;
+}
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+void run(const char* name, int num_buckets, int fill, int rounds){
+    auto buckets = new bucket[num_buckets];
+    std::vector<Key_t> keys(num_buckets * fill);
+    for(auto& k: keys)
+	k = ((uint64_t)rand() << 32) | rand();
+    auto empty = splat(0);
+    uint64_t inserts = (uint64_t)rounds * keys.size();
+
+    double insert_time = 0;
+    for(int r=0; r<rounds; r++){
+	for(int b=0; b<num_buckets; b++)
+	    memset(buckets[b].fingerprints, 0, sizeof(buckets[b].fingerprints));
+	auto start = now();
+	// consecutive keys land in different buckets, as they do in a hash leaf
+	for(int i=0; i<fill; i++){
+	    for(int b=0; b<num_buckets; b++){
+		auto key = keys[b*fill + i];
+		buckets[b].insert(key, key, fingerprint_of(key), empty);
+	    }
+	}
+	insert_time += now() - start;
+    }
+
+    uint64_t found = 0;
+    auto start = now();
+    for(int r=0; r<rounds; r++){
+	for(int b=0; b<num_buckets; b++){
+	    for(int i=0; i<fill; i++){
+		auto key = keys[b*fill + i] + (i & 1); // half hits, half misses
+		Value_t value;
+		found += buckets[b].find(key, value, splat(fingerprint_of(key)));
+	    }
+	}
+    }
+    double find_time = now() - start;
+
+    entry_t<Key_t, Value_t> buf[bucket::entry_num];
+    uint64_t collected = 0;
+    start = now();
+    for(int r=0; r<rounds; r++){
+	for(int b=0; b<num_buckets; b++){
+	    int num = 0;
+	    buckets[b].collect(buf, num, empty);
+	    collected += num;
+	}
+    }
+    double collect_time = now() - start;
+
+    std::cout << variant << " (" << name << ")\t"
+	<< "insert: " << insert_time * 1e9 / inserts << " ns/op\t"
+	<< "find: " << find_time * 1e9 / inserts << " ns/op\t"
+	<< "collect: " << collect_time * 1e9 / ((uint64_t)rounds * num_buckets) << " ns/bucket\t"
+	<< "(found " << found << ", collected " << collected << ")" << std::endl;
+    delete[] buckets;
+}
+
+int main(int argc, char* argv[]){
+    int num_buckets = 1024;
+    int fill = 24;
+    int rounds = 100;
+    if(argc > 1)
+	num_buckets = atoi(argv[1]);
+    if(argc > 2)
+	fill = atoi(argv[2]);
+    if(argc > 3)
+	rounds = atoi(argv[3]);
+    if(fill > bucket::entry_num)
+	fill = bucket::entry_num;
+
+    #ifdef AVX_512
+    const char* names[] = {"sse2", "avx2", "avx512bw"};
+    auto supported = simd_level;
+    for(int level=SIMD_SSE2; level<=supported; level++){
+	simd_level = static_cast<simd_level_t>(level);
+	run(names[level], num_buckets, fill, rounds);
+    }
+    #else
+    run("compile-time", num_buckets, fill, rounds);
+    #endif
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* startup from sorted historical keys: inserting them one by one and converting the hash leaves afterwards
+   against bulk_load building packed btree leaves and the inner levels bottom-up, followed by new monotonic inserts */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+void run(int num_threads, const std::vector<entry_t<Key_t, Value_t>>& history, const std::vector<Key_t>& fresh){
+    auto tree = new btree_t<Key_t, Value_t>();
+    double startup_time, insert_time, read_time;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	auto start = now();
+	if(num_threads == 0){
+	    for(auto& e: history)
+		tree->insert(e.key, e.value, t);
+	    tree->convert_all(t);
+	}
+	else
+	    tree->bulk_load(history.data(), history.size(), FILL_FACTOR, num_threads);
+	startup_time = now() - start;
+
+	start = now();
+	for(auto key: fresh)
+	    tree->insert(key, key, t);
+	insert_time = now() - start;
+
+	std::mt19937_64 gen(1);
+	start = now();
+	for(size_t i=0; i<history.size(); i++){
+	    Value_t value;
+	    auto& e = history[gen() % history.size()];
+	    if(!tree->lookup(e.key, value, t) || value != e.value)
+		miss++;
+	}
+	read_time = now() - start;
+
+	for(auto key: fresh){
+	    Value_t value;
+	    if(!tree->lookup(key, value, t) || value != key)
+		miss++;
+	}
+    }
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    if(num_threads == 0)
+	std::cout << "insert + convert_all\n";
+    else
+	std::cout << "bulk_load, " << num_threads << " threads\n";
+    std::cout << "\tStartup: " << startup_time * 1000 << " ms (" << history.size() / startup_time / 1000000.0 << " mops/sec)\n"
+	<< "\tNew inserts: " << fresh.size() / insert_time / 1000000.0 << " mops/sec\n"
+	<< "\tread: " << read_time * 1e9 / history.size() << " ns/op\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB, height " << tree->height() << "\n"
+	<< "\tWrong keys: " << miss << std::endl;
+    delete tree;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 10000000;
+    int max_threads = 4;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	max_threads = atoi(argv[2]);
+
+    std::mt19937_64 gen(0);
+    std::vector<entry_t<Key_t, Value_t>> history(num_data);
+    Key_t ts = 1600000000000000000ULL;
+    for(auto& e: history){
+	ts += 1000 + gen() % 1000;
+	e.key = ts;
+	e.value = ts;
+    }
+    std::vector<Key_t> fresh(num_data / 10);
+    for(auto& k: fresh){
+	ts += 1000 + gen() % 1000;
+	k = ts;
+    }
+
+    run(0, history, fresh);
+    for(int i=1; i<=max_threads; i*=2)
+	run(i, history, fresh);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* checkpoint of a time-ordered tree taken while writers go on appending, then a cold start restoring the file
+   through bulk_load against inserting the same keys one by one */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+int main(int argc, char* argv[]){
+    size_t num_data = 100000000;
+    int num_writers = 2;
+    int num_threads = 4;
+    const char* path = "checkpoint.dat";
+    if(argc > 1)
+	num_data = atol(argv[1]);
+    if(argc > 2)
+	num_writers = atoi(argv[2]);
+    if(argc > 3)
+	num_threads = atoi(argv[3]);
+    if(argc > 4)
+	path = argv[4];
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> keys(num_data);
+    Key_t ts = 1600000000000000000ULL;
+    for(auto& k: keys){
+	ts += 1000 + gen() % 1000;
+	k = ts;
+    }
+
+    auto tree = new btree_t<Key_t, Value_t>();
+    {
+	auto t = tree->getThreadInfo();
+	for(auto k: keys)
+	    tree->insert(k, k, t);
+    }
+
+    // writers keep appending newer keys while the checkpoint walks the leaves
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> appended{0};
+    std::vector<std::thread> writers;
+    for(int i=0; i<num_writers; i++){
+	writers.emplace_back([&, i](){
+	    auto t = tree->getThreadInfo();
+	    Key_t k = ts + 1 + i;
+	    while(!done.load()){
+		tree->insert(k, k, t);
+		k += num_writers;
+		appended++;
+	    }
+	});
+    }
+
+    bool ok;
+    double checkpoint_time;
+    {
+	auto t = tree->getThreadInfo();
+	auto start = now();
+	ok = tree->checkpoint(path, t);
+	checkpoint_time = now() - start;
+    }
+    done = true;
+    for(auto& w: writers)
+	w.join();
+    delete tree;
+    if(!ok){
+	std::cout << "checkpoint failed" << std::endl;
+	return 1;
+    }
+
+    struct stat st;
+    stat(path, &st);
+    uint64_t num = (st.st_size - sizeof(checkpoint_header_t)) / sizeof(entry_t<Key_t, Value_t>);
+    std::cout << "Checkpoint: " << checkpoint_time * 1000 << " ms, " << st.st_size / 1024 / 1024 << " MB, "
+	<< num << " keys (" << num - num_data << " of " << appended.load() << " concurrent inserts)" << std::endl;
+
+    // restore through bulk_load
+    tree = new btree_t<Key_t, Value_t>();
+    auto start = now();
+    ok = tree->restore(path, num_threads);
+    auto restore_time = now() - start;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	for(auto k: keys){
+	    Value_t value;
+	    if(!tree->lookup(k, value, t) || value != k)
+		miss++;
+	}
+    }
+    delete tree;
+    std::cout << "restore, " << num_threads << " threads: " << restore_time * 1000 << " ms (" << num / restore_time / 1000000.0 << " mops/sec)"
+	<< (ok ? "" : " failed") << ", wrong keys " << miss << std::endl;
+
+    // cold start by reinserting every key
+    tree = new btree_t<Key_t, Value_t>();
+    start = now();
+    {
+	auto t = tree->getThreadInfo();
+	for(auto k: keys)
+	    tree->insert(k, k, t);
+    }
+    auto insert_time = now() - start;
+    delete tree;
+    std::cout << "reinsert: " << insert_time * 1000 << " ms (" << num_data / insert_time / 1000000.0 << " mops/sec)" << std::endl;
+
+    unlink(path);
+    return (ok && miss == 0) ? 0 : 1;
+}
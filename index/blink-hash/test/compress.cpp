@@ -0,0 +1,132 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* footprint per key and lookup/scan cost once every leaf has been converted, for timestamps a few
+   microseconds apart and for random keys; built against blinkhash (btree leaves) and blinkhash_delta (delta leaves),
+   then late keys, updates and removes land in the converted leaves to check they still read back */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+size_t run(const char* name, std::vector<Key_t> keys, int num_probes, int range){
+    std::mt19937_64 gen(1);
+    auto tree = new btree_t<Key_t, Value_t>();
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys)
+	    tree->insert(key, key, t);
+	tree->convert_all(t);
+    }
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto leaves = meta + key_occupied + key_unoccupied;
+    auto total = leaves + structural_occupied + structural_unoccupied;
+
+    std::vector<Key_t> probes(num_probes);
+    for(auto& p: probes)
+	p = keys[gen() % keys.size()];
+
+    uint64_t found = 0, scanned = 0;
+    double read_time, scan_time;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	auto start = now();
+	for(auto key: probes){
+	    Value_t value;
+	    found += tree->lookup(key, value, t);
+	}
+	read_time = now() - start;
+
+	Value_t buf[range];
+	start = now();
+	for(auto key: probes)
+	    scanned += tree->range_lookup(key, range, buf, t);
+	scan_time = now() - start;
+
+	// late keys between the converted ones, then updates and removes of every other key
+	std::vector<Key_t> late;
+	for(size_t i=0; i+1<keys.size(); i+=7){
+	    if(keys[i+1] - keys[i] > 2)
+		late.push_back(keys[i] + 1);
+	}
+	for(auto key: late)
+	    tree->insert(key, key, t);
+	for(size_t i=0; i<keys.size(); i+=2)
+	    tree->update(keys[i], keys[i] + 1, t);
+	for(size_t i=1; i<keys.size(); i+=4)
+	    tree->remove(keys[i], t);
+
+	for(size_t i=0; i<keys.size(); i++){
+	    Value_t value;
+	    bool ret = tree->lookup(keys[i], value, t);
+	    if(i % 4 == 1)
+		miss += ret;
+	    else if(!ret || value != keys[i] + (i % 2 == 0))
+		miss++;
+	}
+	for(auto key: late){
+	    Value_t value;
+	    if(!tree->lookup(key, value, t) || value != key)
+		miss++;
+	}
+    }
+
+    std::cout << name << "\n"
+	<< "\tFootprint: " << (double)total / keys.size() << " bytes/key (leaves " << (double)leaves / keys.size() << ", key data utilization " << (double)key_occupied / (key_occupied + key_unoccupied) << ")\n"
+	<< "\tread: " << read_time * 1e9 / probes.size() << " ns/op, scan(" << range << "): " << scan_time * 1e9 / probes.size() << " ns/op, "
+	<< (double)scanned / scan_time / 1000000.0 << " Mkeys/sec (found " << found << "/" << probes.size() << ")\n"
+	<< "\tWrong after late inserts, updates and removes: " << miss << std::endl;
+    delete tree;
+    return miss;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 10000000;
+    int num_probes = 1000000;
+    int range = 100;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	num_probes = atoi(argv[2]);
+    if(argc > 3)
+	range = atoi(argv[3]);
+
+    #ifdef DELTA_LEAF
+    std::cout << "delta leaves\n";
+    #else
+    std::cout << "btree leaves\n";
+    #endif
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> timestamps(num_data);
+    Key_t ts = 1600000000000000000ULL;
+    for(auto& k: timestamps){
+	ts += 1000 + gen() % 1000;
+	k = ts;
+    }
+    size_t miss = run("timestamps (1-2 us apart)", timestamps, num_probes, range);
+
+    std::vector<Key_t> random(num_data);
+    for(auto& k: random)
+	k = gen() | 1;
+    miss += run("random", random, num_probes, range);
+    return (miss == 0) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include "tree.h"
+
+#include <ctime>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <iostream>
+
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+using namespace BLINK_HASH;
+
+/* every thread inserting timestamps, so that all of them hit the rightmost hash leaf, and looking up keys it
+   inserted; throughput and restarts by cause, built once per backoff policy (contention, contention_backoff,
+   contention_park), restarts without backoff are counted by contention_breakdown */
+
+inline uint64_t _Rdtsc(){
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+    return (((uint64_t)hi << 32 ) | lo);
+}
+
+int main(int argc, char* argv[]){
+    size_t num_data = 10000000;
+    int num_threads = 64;
+    if(argc > 1)
+	num_data = atol(argv[1]);
+    if(argc > 2)
+	num_threads = atoi(argv[2]);
+
+    auto tree = new btree_t<Key_t, Value_t>();
+    std::atomic<uint64_t> restarts[RESTART_CAUSES] = {};
+    std::atomic<uint64_t> miss{0};
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> threads;
+    for(int tid=0; tid<num_threads; tid++){
+	threads.emplace_back([&, tid](){
+		auto t = tree->getThreadInfo();
+		size_t chunk = num_data / num_threads;
+		Key_t last = 0;
+		uint64_t _miss = 0;
+		for(size_t i=0; i<chunk; i++){
+		    auto key = (_Rdtsc() << 6) | tid;
+		    tree->insert(key, key, t);
+		    if((i % 4 == 3) && (tree->lookup(last, t) != last))
+			_miss++;
+		    last = key;
+		}
+		miss += _miss;
+
+		uint64_t count[RESTART_CAUSES];
+		tree->restart_stats(count);
+		for(int i=0; i<RESTART_CAUSES; i++)
+		    restarts[i] += count[i];
+		});
+    }
+    for(auto& t: threads)
+	t.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    std::cout << num_threads << " threads: " << num_data / (elapsed / 1000000000.0) / 1000000 << " mops/sec inserts\n\trestarts:";
+    #if defined(BREAKDOWN) || defined(BACKOFF)
+    const char* causes[RESTART_CAUSES] = {"version", "bucket", "split", "convert"};
+    for(int i=0; i<RESTART_CAUSES; i++)
+	std::cout << " " << causes[i] << " " << restarts[i].load();
+    #else
+    std::cout << " not counted";
+    #endif
+    std::cout << "\n\tWrong keys: " << miss.load() << std::endl;
+    delete tree;
+    return miss.load() ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <thread>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* insert throughput, split frequency and footprint of every pre-instantiated geometry
+   under timeseries (rdtsc-ordered) insertion */
+
+inline uint64_t Rdtsc(){
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+    return (((uint64_t) hi << 32) | lo);
+}
+
+template <typename Geometry_t>
+void run(const char* name, int num_data, int num_threads){
+    auto tree = new btree_t<Key_t, Value_t, Geometry_t>();
+
+    auto load = [tree, num_data, num_threads](uint64_t tid){
+	auto t = tree->attach_thread();
+	int sensor_id = 0;
+	size_t chunk = num_data / num_threads;
+	for(size_t i=0; i<chunk; i++){
+	    Key_t key = ((Rdtsc() << 16) | sensor_id++ << 6) | tid;
+	    tree->insert(key, key, *t);
+	    if(sensor_id == 1024)
+		sensor_id = 0;
+	}
+	tree->detach_thread(t);
+    };
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> threads;
+    for(int i=0; i<num_threads; i++)
+	threads.emplace_back(load, i);
+    for(auto& t: threads)
+	t.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    auto elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    auto tput = (double)num_data / (elapsed/1000000000.0) / 1000000.0;
+
+    uint64_t leaf_splits, inner_splits;
+    tree->split_stats(leaf_splits, inner_splits);
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    std::cout << name << " (leaf " << Geometry_t::leaf_hash_size / 1024 << "KB, page " << Geometry_t::page_size
+	<< "B, entries " << Geometry_t::entry_num << ", slots " << Geometry_t::num_slot << ", hashes " << Geometry_t::hash_funcs_num << ")\n"
+	<< "\tInsertion: " << tput << " mops/sec\n"
+	<< "\tLeaf splits: " << leaf_splits << " (" << leaf_splits * 1000000.0 / num_data << " per M inserts)\n"
+	<< "\tInner splits: " << inner_splits << "\n"
+	<< "\tHeight: " << tree->height() << "\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB (key data utilization " << (double)key_occupied / (key_occupied + key_unoccupied) << ")" << std::endl;
+    delete tree;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+	std::cerr << "usage: " << argv[0] << " num_data num_threads" << std::endl;
+	return 1;
+    }
+    int num_data = atoi(argv[1]);
+    int num_threads = atoi(argv[2]);
+
+    run<default_geometry_t>("default", num_data, num_threads);
+    run<leaf_64k_geometry_t>("leaf_64k", num_data, num_threads);
+    run<leaf_1m_geometry_t>("leaf_1m", num_data, num_threads);
+    run<page_1k_geometry_t>("page_1k", num_data, num_threads);
+    run<slot_8_geometry_t>("slot_8", num_data, num_threads);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <x86intrin.h>
+
+#include "lnode.h"
+#include "hash.cpp"
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+using leaf = lnode_hash_t<Key_t, Value_t>;
+
+/* cost of computing the probe sequence (bucket and fingerprint of every hash function) of a hash leaf,
+   and how full a leaf gets before its first insert fails and it has to split,
+   for the byte-oriented function table against the inlined 64-bit hasher, on rdtsc keys */
+
+struct bytes_hasher_t{
+    static inline size_t hash(Key_t key, int func_num){ return h(&key, sizeof(Key_t), func_num); }
+};
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+template <typename Hasher>
+void run(const char* name, const std::vector<Key_t>& keys, int rounds){
+    uint64_t sink = 0;
+    auto start = now();
+    for(int r=0; r<rounds; r++){
+	for(auto key: keys){
+	    for(int k=0; k<leaf::hash_funcs_num; k++){
+		auto hash_key = Hasher::hash(key, k);
+		sink += (hash_key % leaf::cardinality) ^ (uint8_t)(hash_key | 1);
+	    }
+	}
+    }
+    double probe_time = now() - start;
+
+    // replays bucket placement of lnode_hash_t::insert until a key finds no free slot
+    std::vector<int> load(leaf::cardinality);
+    uint64_t leaves = 0, filled = 0;
+    double min_fill = 1.0;
+    size_t idx = 0;
+    while(idx < keys.size()){
+	std::fill(load.begin(), load.end(), 0);
+	uint64_t num = 0;
+	for(; idx < keys.size(); idx++){
+	    bool inserted = false;
+	    for(int k=0; k<leaf::hash_funcs_num && !inserted; k++){
+		auto hash_key = Hasher::hash(keys[idx], k);
+		for(int j=0; j<leaf::num_slot; j++){
+		    auto loc = (hash_key + j) % leaf::cardinality;
+		    if(load[loc] < leaf::entry_num){
+			load[loc]++;
+			inserted = true;
+			break;
+		    }
+		}
+	    }
+	    if(!inserted)
+		break;
+	    num++;
+	}
+	if(idx == keys.size()) // last leaf never split
+	    break;
+
+	double fill = (double)num / (leaf::cardinality * leaf::entry_num);
+	leaves++;
+	filled += num;
+	if(fill < min_fill)
+	    min_fill = fill;
+	idx++; // the failed key goes to the next leaf
+    }
+
+    std::cout << name << "\t"
+	<< "probe: " << probe_time * 1e9 / ((uint64_t)rounds * keys.size()) << " ns/key\t"
+	<< "fill at split: avg " << (leaves ? (double)filled / (leaves * leaf::cardinality * leaf::entry_num) * 100 : 0) << " %, min " << min_fill * 100 << " %\t"
+	<< "(" << leaves << " leaves, " << (sink & 1) << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 10000000;
+    int rounds = 10;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	rounds = atoi(argv[2]);
+
+    // same shape as the timeseries workload: rdtsc shifted left with the thread id in the low bits
+    std::vector<Key_t> keys(num_data);
+    for(auto& k: keys)
+	k = (__rdtsc() << 6) | 0;
+
+    run<bytes_hasher_t>("hash_funcs", keys, rounds);
+    run<hasher_t<Key_t>>("hasher_t", keys, rounds);
+    return 0;
+}
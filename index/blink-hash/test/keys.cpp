@@ -0,0 +1,117 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+
+/* insert, lookup and scan cost and footprint of the same library instantiated for integer keys and for
+   email- and url-like string keys */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+std::string word(std::mt19937_64& gen, int min_len, int max_len){
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    int len = min_len + gen() % (max_len - min_len + 1);
+    std::string s;
+    for(int i=0; i<len; i++)
+	s += letters[gen() % 36];
+    return s;
+}
+
+inline key64_t tree_key(key64_t key){ return key; }
+
+inline string_key_t tree_key(const std::string& key){ return make_key(key.data(), key.size()); }
+
+template <typename Key_t, typename Input_t>
+void run(const char* name, const std::vector<Input_t>& keys){
+    auto tree = new btree_t<Key_t, value64_t>();
+    double insert_time, lookup_time, scan_time;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	auto start = now();
+	for(size_t i=0; i<keys.size(); i++)
+	    tree->insert(tree_key(keys[i]), i+1, t);
+	insert_time = now() - start;
+
+	std::mt19937_64 gen(1);
+	start = now();
+	for(size_t i=0; i<keys.size(); i++){
+	    auto j = gen() % keys.size();
+	    if(tree->lookup(tree_key(keys[j]), t) != j+1)
+		miss++;
+	}
+	lookup_time = now() - start;
+
+	tree->convert_all(t);
+	value64_t buf[100];
+	start = now();
+	size_t scans = keys.size() / 100;
+	for(size_t i=0; i<scans; i++){
+	    auto j = gen() % keys.size();
+	    tree->range_lookup(tree_key(keys[j]), 100, buf, t);
+	}
+	scan_time = now() - start;
+	scan_time = scans ? scan_time * 1e9 / scans : 0;
+    }
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    std::cout << name << " keys (" << sizeof(Key_t) << "-byte key slots)\n"
+	<< "\tinsert: " << keys.size() / insert_time / 1000000.0 << " mops/sec\n"
+	<< "\tlookup: " << keys.size() / lookup_time / 1000000.0 << " mops/sec\n"
+	<< "\tscan 100: " << scan_time << " ns/op\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB (" << (double)total / keys.size() << " bytes per key)\n"
+	<< "\tWrong keys: " << miss << std::endl;
+    delete tree;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 1000000;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+
+    std::mt19937_64 gen(0);
+    std::vector<key64_t> ints;
+    for(int i=0; i<num_data; i++)
+	ints.push_back((gen() >> 1) + 1);
+
+    const char* domains[] = {"gmail.com", "yahoo.com", "hotmail.com", "outlook.com", "example.org", "mail.ru"};
+    std::vector<std::string> emails, urls;
+    for(int i=0; i<num_data; i++)
+	emails.push_back(word(gen, 4, 14) + "@" + domains[gen() % 6]);
+    std::vector<std::string> sites;
+    for(int i=0; i<1000; i++)
+	sites.push_back("https://www." + word(gen, 5, 12) + ".com/");
+    for(int i=0; i<num_data; i++)
+	urls.push_back(sites[gen() % sites.size()] + word(gen, 4, 10) + "/" + word(gen, 4, 16) + "?id=" + std::to_string(gen() % 100000));
+
+    std::sort(ints.begin(), ints.end());
+    ints.erase(std::unique(ints.begin(), ints.end()), ints.end());
+    std::shuffle(ints.begin(), ints.end(), gen);
+    for(auto* keys: {&emails, &urls}){
+	std::sort(keys->begin(), keys->end());
+	keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+	std::shuffle(keys->begin(), keys->end(), gen);
+    }
+
+    run<key64_t>("integer", ints);
+    run<string_key_t>("email", emails);
+    run<string_key_t>("url", urls);
+    return 0;
+}
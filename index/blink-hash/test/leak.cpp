@@ -0,0 +1,96 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <thread>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* builds, converts and tears down a tree over and over;
+   resident memory must level off after the first round if every retired and live node is reclaimed */
+
+template <typename Fn, typename... Args>
+void start_threads(btree_t<Key_t, Value_t>* tree, uint64_t num_threads, Fn&& fn, Args&& ...args){
+    std::vector<std::thread> threads;
+    for(uint64_t thread_iter=0; thread_iter<num_threads; ++thread_iter){
+        threads.emplace_back(std::thread(fn, thread_iter, std::ref(args...)));
+    }
+
+    for(auto& t: threads) t.join();
+}
+
+inline uint64_t resident_kb(){
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if(fp == nullptr)
+	return 0;
+    uint64_t size = 0, resident = 0;
+    if(fscanf(fp, "%lu %lu", &size, &resident) != 2)
+	resident = 0;
+    fclose(fp);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+	std::cerr << "usage: " << argv[0] << " num_data iterations [num_threads]" << std::endl;
+	return 1;
+    }
+    int num_data = atoi(argv[1]);
+    int iterations = atoi(argv[2]);
+    int num_threads = 1;
+    if(argc > 3)
+	num_threads = atoi(argv[3]);
+
+    uint64_t baseline = 0;
+    uint64_t last = 0;
+    for(int iter=0; iter<iterations; iter++){
+	auto tree = new btree_t<Key_t, Value_t>();
+
+	auto load = [tree, num_data, num_threads](uint64_t tid, bool){
+	    auto t = tree->attach_thread();
+	    size_t chunk = num_data / num_threads;
+	    for(size_t i=0; i<chunk; i++){
+		Key_t key = (i * num_threads + tid) + 1;
+		tree->insert(key, key, *t);
+	    }
+	    tree->detach_thread(t);
+	};
+
+	// scans convert the hash leaves they touch, which retires the hash nodes through the epoch
+	auto scan = [tree, num_data, num_threads](uint64_t tid, bool){
+	    auto t = tree->attach_thread();
+	    Value_t buf[100];
+	    size_t chunk = num_data / num_threads;
+	    for(size_t i=0; i<chunk; i+=50){
+		Key_t key = (i * num_threads + tid) + 1;
+		tree->range_lookup(key, 100, buf, *t);
+	    }
+	    tree->detach_thread(t);
+	};
+
+	start_threads(tree, num_threads, load, false);
+	start_threads(tree, num_threads, scan, false);
+	delete tree;
+
+	last = resident_kb();
+	if(iter == 0)
+	    baseline = last;
+	std::cout << "iteration " << iter << ": " << last << " KB resident" << std::endl;
+    }
+
+    // allow for allocator slack, but not for a round's worth of nodes
+    if(last > baseline + baseline / 10 + 4096){
+	std::cout << "FAILED: resident memory grew from " << baseline << " KB to " << last << " KB" << std::endl;
+	return 1;
+    }
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* footprint and scan cost after the oldest 90% of time-ordered keys are removed, as a retention window does:
+   hash leaves left behind empty until compact() merges them away, and converted btree leaves
+   with and without the merge that remove triggers on underfull leaves */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+size_t report(const char* name, btree_t<Key_t, Value_t>* tree, const std::vector<Key_t>& keys, size_t removed, int num_scans, int range){
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    uint64_t scanned = 0;
+    double oldest_time, random_time;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	std::mt19937_64 gen(1);
+	Value_t buf[range];
+	// the first scan from the oldest key walks through every leaf left behind by the removes
+	auto start = now();
+	for(int i=0; i<num_scans; i++)
+	    scanned += tree->range_lookup(0, range, buf, t);
+	oldest_time = now() - start;
+
+	start = now();
+	for(int i=0; i<num_scans; i++)
+	    scanned += tree->range_lookup(keys[removed + gen() % (keys.size() - removed)], range, buf, t);
+	random_time = now() - start;
+
+	for(size_t i=0; i<keys.size(); i++){
+	    Value_t value;
+	    bool ret = tree->lookup(keys[i], value, t);
+	    if(i < removed)
+		miss += ret;
+	    else if(!ret || value != keys[i])
+		miss++;
+	}
+    }
+
+    uint64_t merged, rebalanced;
+    tree->merge_stats(merged, rebalanced);
+    std::cout << name << "\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB, " << (double)total / (keys.size() - removed) << " bytes/remaining key, height " << tree->height() << "\n"
+	<< "\tscan(" << range << ") from the oldest key: " << oldest_time * 1e9 / num_scans << " ns/op, from a random key: " << random_time * 1e9 / num_scans << " ns/op\n"
+	<< "\tMerged: " << merged << ", rebalanced: " << rebalanced << "\n"
+	<< "\tWrong keys: " << miss << std::endl;
+    return miss;
+}
+
+size_t run(bool convert, double threshold, const std::vector<Key_t>& keys, int num_scans, int range){
+    auto tree = new btree_t<Key_t, Value_t>();
+    tree->set_merge_threshold(threshold);
+    size_t removed = keys.size() * 9 / 10;
+    double remove_time;
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys)
+	    tree->insert(key, key, t);
+	if(convert)
+	    tree->convert_all(t);
+
+	auto start = now();
+	for(size_t i=0; i<removed; i++)
+	    tree->remove(keys[i], t);
+	remove_time = now() - start;
+    }
+
+    std::string name = convert ? "converted leaves, merge threshold " + std::to_string(threshold) : "hash leaves";
+    std::cout << "Remove: " << removed / remove_time / 1000000.0 << " mops/sec" << std::endl;
+    size_t miss = report(name.c_str(), tree, keys, removed, num_scans, range);
+
+    uint64_t retired;
+    double compact_time;
+    {
+	auto t = tree->getThreadInfo();
+	auto start = now();
+	retired = tree->compact(t);
+	compact_time = now() - start;
+    }
+    std::cout << "Compact: " << retired << " nodes retired in " << compact_time * 1000 << " ms" << std::endl;
+    miss += report((name + ", compacted").c_str(), tree, keys, removed, num_scans, range);
+    delete tree;
+    return miss;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 10000000;
+    int num_scans = 100000;
+    int range = 100;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	num_scans = atoi(argv[2]);
+    if(argc > 3)
+	range = atoi(argv[3]);
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> keys(num_data);
+    Key_t ts = 1600000000000000000ULL;
+    for(auto& k: keys){
+	ts += 1000 + gen() % 1000;
+	k = ts;
+    }
+
+    size_t miss = run(false, 0.25, keys, num_scans, range);
+    miss += run(true, 0, keys, num_scans, range);
+    miss += run(true, 0.25, keys, num_scans, range);
+    return (miss == 0) ? 0 : 1;
+}
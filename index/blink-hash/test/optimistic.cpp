@@ -0,0 +1,150 @@
+#include "tree.h"
+
+#include <ctime>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+using namespace BLINK_HASH;
+
+/* readers looking keys up while writers shift and split btree leaves, an appender fills hash leaves at the
+   tail and a converter keeps turning them into btree leaves; a key written before the lookup started must be
+   found with its value (lost), a key that is never written must not be (phantom) */
+
+int main(int argc, char* argv[]){
+    int num_data = 4000000;
+    int num_readers = 2;
+    int num_writers = 2;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	num_readers = atoi(argv[2]);
+    if(argc > 3)
+	num_writers = atoi(argv[3]);
+
+    // 4i+4 preloaded, 4i+2 written during the run, odd keys never
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> preload(num_data), written(num_data);
+    for(int i=0; i<num_data; i++){
+	preload[i] = 4*(Key_t)i + 4;
+	written[i] = 4*(Key_t)i + 2;
+    }
+    std::shuffle(preload.begin(), preload.end(), gen);
+    std::shuffle(written.begin(), written.end(), gen);
+    Key_t append_base = 4*(Key_t)num_data + 4;
+
+    auto tree = new btree_t<Key_t, Value_t>();
+    {
+	auto t = tree->getThreadInfo();
+	for(auto k: preload)
+	    tree->insert(k, k, t);
+	tree->convert_all(t);
+    }
+
+    // progress[w]: written[] entries of writer w known to be in the tree, appended: appended keys known to be
+    std::vector<std::atomic<int>> progress(num_writers);
+    for(auto& p: progress)
+	p = 0;
+    std::atomic<uint64_t> appended{0};
+    std::atomic<int> writers_done{0};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> lost{0}, phantom{0}, reads{0};
+
+    std::vector<std::thread> threads;
+    for(int w=0; w<num_writers; w++){
+	threads.emplace_back([&, w](){
+		auto t = tree->getThreadInfo();
+		for(int i=w; i<num_data; i+=num_writers){
+		    tree->insert(written[i], written[i], t);
+		    progress[w].store(i / num_writers + 1);
+		}
+		writers_done++;
+		});
+    }
+    threads.emplace_back([&](){
+	    auto t = tree->getThreadInfo();
+	    while(!done.load()){
+		auto n = appended.load();
+		tree->insert(append_base + 2*n, append_base + 2*n, t);
+		appended.store(n + 1);
+	    }
+	    });
+    threads.emplace_back([&](){
+	    auto t = tree->getThreadInfo();
+	    while(!done.load())
+		tree->convert_all(t);
+	    });
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> readers;
+    for(int r=0; r<num_readers; r++){
+	readers.emplace_back([&, r](){
+		auto t = tree->getThreadInfo();
+		std::mt19937_64 rgen(r + 1);
+		uint64_t _lost = 0, _phantom = 0, _reads = 0;
+		while(writers_done.load() < num_writers){
+		    Key_t key;
+		    bool expected;
+		    switch(rgen() % 4){
+			case 0:
+			    key = preload[rgen() % num_data];
+			    expected = true;
+			    break;
+			case 1:{
+			    int w = rgen() % num_writers;
+			    int n = progress[w].load();
+			    if(n == 0)
+				continue;
+			    key = written[(rgen() % n) * num_writers + w];
+			    expected = true;
+			    break;
+			}
+			case 2:{
+			    auto n = appended.load();
+			    if(n == 0)
+				continue;
+			    key = append_base + 2*(rgen() % n);
+			    expected = true;
+			    break;
+			}
+			default:
+			    key = 2*(rgen() % (2*(uint64_t)num_data + appended.load())) + 1;
+			    expected = false;
+		    }
+
+		    Value_t value;
+		    bool found = tree->lookup(key, value, t);
+		    if(expected && (!found || value != key))
+			_lost++;
+		    else if(!expected && found)
+			_phantom++;
+		    _reads++;
+		}
+		lost += _lost;
+		phantom += _phantom;
+		reads += _reads;
+		});
+    }
+    for(auto& r: readers)
+	r.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    done = true;
+    for(auto& t: threads)
+	t.join();
+
+    uint64_t leaf_splits, inner_splits;
+    tree->split_stats(leaf_splits, inner_splits);
+    uint64_t elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    std::cout << num_readers << " readers, " << num_writers << " writers, appender and converter\n"
+	<< "\treads: " << reads.load() / (elapsed / 1000000000.0) / 1000000 << " mops/sec\n"
+	<< "\twrites: " << (num_data + appended.load()) / (elapsed / 1000000000.0) / 1000000 << " mops/sec, leaf splits: " << leaf_splits << "\n"
+	<< "\tLost keys: " << lost.load() << ", phantom keys: " << phantom.load() << std::endl;
+    delete tree;
+    return (lost.load() == 0 && phantom.load() == 0) ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* insert throughput and footprint when late keys overflow older hash leaves,
+   splitting them against converting them to btree leaves above a utilization threshold;
+   keys arrive in timestamp order except for a fraction delayed by an exponential number of positions */
+
+size_t run(double min_util, const std::vector<Key_t>& keys, int num_threads){
+    auto tree = new btree_t<Key_t, Value_t>();
+    tree->set_overflow_convert(min_util);
+
+    auto load = [&](int tid){
+	auto t = tree->attach_thread();
+	for(size_t i=tid; i<keys.size(); i+=num_threads)
+	    tree->insert(keys[i], keys[i], *t);
+	tree->detach_thread(t);
+    };
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> threads;
+    for(int i=0; i<num_threads; i++)
+	threads.emplace_back(load, i);
+    for(auto& t: threads)
+	t.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    auto elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    auto tput = (double)keys.size() / (elapsed/1000000000.0) / 1000000.0;
+
+    uint64_t converted, split, leaf_splits, inner_splits;
+    tree->overflow_stats(converted, split);
+    tree->split_stats(leaf_splits, inner_splits);
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    // late keys must still be found whether their leaf was split or converted
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys){
+	    Value_t value;
+	    if(!tree->lookup(key, value, t) || value != key)
+		miss++;
+	}
+    }
+
+    std::cout << "overflow_util " << min_util << "\n"
+	<< "\tInsertion: " << tput << " mops/sec\n"
+	<< "\tOverflowed older leaves: " << converted << " converted, " << split << " split (" << leaf_splits << " leaf splits in total)\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB (key data utilization " << (double)key_occupied / (key_occupied + key_unoccupied) << ")\n"
+	<< "\tMissing keys: " << miss << std::endl;
+    delete tree;
+    return miss;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+	std::cerr << "usage: " << argv[0] << " num_data num_threads [late_ratio] [mean_delay]" << std::endl;
+	return 1;
+    }
+    int num_data = atoi(argv[1]);
+    int num_threads = atoi(argv[2]);
+    double late_ratio = 0.2;
+    double mean_delay = 100000;
+    if(argc > 3)
+	late_ratio = atof(argv[3]);
+    if(argc > 4)
+	mean_delay = atof(argv[4]);
+
+    std::mt19937_64 gen(0);
+    std::bernoulli_distribution late(late_ratio);
+    std::exponential_distribution<double> delay(1.0 / mean_delay);
+    std::vector<std::pair<double, Key_t>> arrival(num_data);
+    for(int i=0; i<num_data; i++){
+	double pos = i;
+	if(late(gen))
+	    pos += delay(gen);
+	arrival[i] = std::make_pair(pos, ((Key_t)(i + 1) << 6));
+    }
+    std::sort(arrival.begin(), arrival.end());
+    std::vector<Key_t> keys(num_data);
+    for(int i=0; i<num_data; i++)
+	keys[i] = arrival[i].second;
+
+    size_t miss = 0;
+    for(auto min_util: {0.0, 0.6, 0.8, 0.9})
+	miss += run(min_util, keys, num_threads);
+    return (miss == 0) ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* point lookup and scan cost once every leaf has been converted to a btree leaf, so that each
+   operation is a lower-bound search in every inner node on the path and in the leaf;
+   built against blinkhash (entry_t array) and blinkhash_soa, which repeats the run for every kernel the CPU supports */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+void run(const char* name, btree_t<Key_t, Value_t>* tree, const std::vector<Key_t>& keys, const std::vector<Key_t>& probes, int range){
+    auto t = tree->getThreadInfo();
+    uint64_t found = 0;
+    auto start = now();
+    for(auto key: probes){
+	Value_t value;
+	found += tree->lookup(key, value, t);
+    }
+    double read_time = now() - start;
+
+    Value_t buf[range];
+    uint64_t scanned = 0;
+    start = now();
+    for(auto key: probes)
+	scanned += tree->range_lookup(key, range, buf, t);
+    double scan_time = now() - start;
+
+    std::cout << name << "\t"
+	<< "read: " << read_time * 1e9 / probes.size() << " ns/op\t"
+	<< "scan(" << range << "): " << scan_time * 1e9 / probes.size() << " ns/op\t"
+	<< "(found " << found << "/" << probes.size() << ", scanned " << scanned << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 10000000;
+    int num_probes = 10000000;
+    int range = 50;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+    if(argc > 2)
+	num_probes = atoi(argv[2]);
+    if(argc > 3)
+	range = atoi(argv[3]);
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> keys(num_data);
+    for(auto& k: keys)
+	k = gen() | 1;
+
+    auto tree = new btree_t<Key_t, Value_t>();
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys)
+	    tree->insert(key, key, t);
+	tree->convert_all(t);
+    }
+    std::cout << "height: " << tree->height() << std::endl;
+
+    std::vector<Key_t> probes(num_probes);
+    for(auto& p: probes)
+	p = keys[gen() % num_data];
+
+    #ifdef SOA_NODE
+    const char* names[] = {"soa scalar", "soa avx2", "soa avx512"};
+    auto supported = search_level;
+    for(int level=SEARCH_SCALAR; level<=supported; level++){
+	search_level = static_cast<search_level_t>(level);
+	run(names[level], tree, keys, probes, range);
+    }
+    #else
+    run("entry_t", tree, keys, probes, range);
+    #endif
+    delete tree;
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* insert latency tail and leaf split stall with the buckets linked by leaf splits left to
+   first touch and the next split of the leaf, against migrating them in the background sweeper;
+   random keys so that leaves all over the tree split with linked buckets left behind */
+
+inline uint64_t Rdtsc(){
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+    return (((uint64_t) hi << 32) | lo);
+}
+
+size_t run(bool sweep, const std::vector<Key_t>& keys, int num_threads){
+    auto tree = new btree_t<Key_t, Value_t>();
+    if(sweep)
+	tree->start_sweeper();
+
+    std::vector<std::vector<uint64_t>> latency(num_threads);
+    auto load = [&](int tid){
+	auto t = tree->attach_thread();
+	auto& lat = latency[tid];
+	for(size_t i=tid; i<keys.size(); i+=num_threads){
+	    auto start = Rdtsc();
+	    tree->insert(keys[i], keys[i], *t);
+	    lat.push_back(Rdtsc() - start);
+	}
+	tree->detach_thread(t);
+    };
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> threads;
+    for(int i=0; i<num_threads; i++)
+	threads.emplace_back(load, i);
+    for(auto& t: threads)
+	t.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    tree->stop_sweeper();
+
+    auto elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    auto tput = (double)keys.size() / (elapsed/1000000000.0) / 1000000.0;
+
+    std::vector<uint64_t> all;
+    for(auto& lat: latency)
+	all.insert(all.end(), lat.begin(), lat.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&all](double p){ return all[(size_t)(p * (all.size() - 1))]; };
+
+    uint64_t hist[btree_t<Key_t, Value_t>::split_stall_buckets];
+    tree->split_stall_stats(hist);
+    uint64_t splits = 0, median = 0, seen = 0;
+    for(auto h: hist)
+	splits += h;
+    for(int i=0; i<btree_t<Key_t, Value_t>::split_stall_buckets; i++){
+	seen += hist[i];
+	if(seen * 2 >= splits){
+	    median = i;
+	    break;
+	}
+    }
+
+    uint64_t swept, missed;
+    tree->sweep_stats(swept, missed);
+
+    // buckets still linked at the end must be found through the fix-up on first touch
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys){
+	    Value_t value;
+	    if(!tree->lookup(key, value, t) || value != key)
+		miss++;
+	}
+    }
+
+    std::cout << (sweep ? "sweeper" : "first touch") << "\n"
+	<< "\tInsertion: " << tput << " mops/sec\n"
+	<< "\tInsert latency (cycles): p50 " << pct(0.5) << ", p99 " << pct(0.99) << ", p99.9 " << pct(0.999) << ", p99.99 " << pct(0.9999) << ", max " << all.back() << "\n"
+	<< "\tLeaf splits: " << splits << ", median stall 2^" << median << " cycles\n"
+	<< "\tSwept: " << swept << ", missed: " << missed << "\n"
+	<< "\tMissing keys: " << miss << std::endl;
+    delete tree;
+    return miss;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+	std::cerr << "usage: " << argv[0] << " num_data num_threads" << std::endl;
+	return 1;
+    }
+    int num_data = atoi(argv[1]);
+    int num_threads = atoi(argv[2]);
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> keys(num_data);
+    for(auto& k: keys)
+	k = gen() | 1;
+
+    size_t miss = run(false, keys, num_threads);
+    miss += run(true, keys, num_threads);
+    return (miss == 0) ? 0 : 1;
+}
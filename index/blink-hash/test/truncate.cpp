@@ -0,0 +1,88 @@
+#include "tree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <random>
+
+using namespace std;
+using namespace BLINK_HASH;
+using Key_t = uint64_t;
+using Value_t = uint64_t;
+
+/* truncation of the oldest 50% of time-ordered keys, as a retention window does: a loop of per-key removes
+   against remove_range, which unlinks and retires the leaves inside the range a parent at a time */
+
+inline double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+
+void run(bool convert, bool range, const std::vector<Key_t>& keys){
+    auto tree = new btree_t<Key_t, Value_t>();
+    size_t half = keys.size() / 2;
+    uint64_t removed = 0;
+    double remove_time;
+    size_t miss = 0;
+    {
+	auto t = tree->getThreadInfo();
+	for(auto key: keys)
+	    tree->insert(key, key, t);
+	if(convert)
+	    tree->convert_all(t);
+
+	auto start = now();
+	if(range)
+	    removed = tree->remove_range(keys[0], keys[half-1], t);
+	else{
+	    for(size_t i=0; i<half; i++)
+		removed += tree->remove(keys[i], t);
+	}
+	remove_time = now() - start;
+
+	for(size_t i=0; i<keys.size(); i++){
+	    Value_t value;
+	    bool ret = tree->lookup(keys[i], value, t);
+	    if(i < half)
+		miss += ret;
+	    else if(!ret || value != keys[i])
+		miss++;
+	}
+    }
+
+    uint64_t meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied;
+    meta = structural_occupied = structural_unoccupied = key_occupied = key_unoccupied = 0;
+    tree->footprint(meta, structural_occupied, structural_unoccupied, key_occupied, key_unoccupied);
+    auto total = meta + structural_occupied + structural_unoccupied + key_occupied + key_unoccupied;
+
+    uint64_t merged, rebalanced;
+    tree->merge_stats(merged, rebalanced);
+    std::cout << (convert ? "converted leaves, " : "hash leaves, ") << (range ? "remove_range" : "per-key remove") << "\n"
+	<< "\tTruncate: " << remove_time * 1000 << " ms, " << removed << " keys removed (" << half / remove_time / 1000000.0 << " mops/sec)\n"
+	<< "\tFootprint: " << total / 1024 / 1024 << " MB, height " << tree->height() << ", merged: " << merged << "\n"
+	<< "\tWrong keys: " << miss + (removed != half) << std::endl;
+    delete tree;
+}
+
+int main(int argc, char* argv[]){
+    int num_data = 100000000;
+    if(argc > 1)
+	num_data = atoi(argv[1]);
+
+    std::mt19937_64 gen(0);
+    std::vector<Key_t> keys(num_data);
+    Key_t ts = 1600000000000000000ULL;
+    for(auto& k: keys){
+	ts += 1000 + gen() % 1000;
+	k = ts;
+    }
+
+    for(auto convert: {false, true}){
+	run(convert, false, keys);
+	run(convert, true, keys);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+## measure load throughput of batched insertion
+
+mkdir output
+mkdir output/batch
+output_ts=output/batch/ts
+mkdir $output_ts
+
+index="blinkhash"
+threads="1 4 8 16 32 64"
+batches="1 2 4 8 16 32 64 128 256 512 1024"
+iterations="1 2 3"
+num=100
+
+## timeseries keys --- monotonic insertion
+for iter in $iterations; do
+	for idx in $index; do
+		for b in $batches; do
+			for t in $threads; do
+				echo "---------------- running with threads $t batch $b ----------------" >> ${output_ts}/${idx}_load_batch${b}
+				./bin/timeseries --index $idx --num $num --workload load --threads $t --batch $b --hyper --earliest >> ${output_ts}/${idx}_load_batch${b}
+			done
+		done
+	done
+done
+
+## measure throughput of batched point reads
+for iter in $iterations; do
+	for idx in $index; do
+		for b in $batches; do
+			for t in $threads; do
+				echo "---------------- running with threads $t read batch $b ----------------" >> ${output_ts}/${idx}_read_batch${b}
+				./bin/timeseries --index $idx --num $num --workload read --threads $t --read_batch $b --hyper --earliest >> ${output_ts}/${idx}_read_batch${b}
+			done
+		done
+	done
+done
@@ -14,3 +14,10 @@ for idx in $index; do
 		./bin/timeseries_breakdown --workload load --num $num --index $idx --threads $t --hyper --earliest --insert_only >> ${path_breakdown}/${idx}.${t}
 	done
 done
+
+## blinkhash with and without the rightmost-leaf cache
+for tail in true false; do
+	for t in $threads; do
+		./bin/timeseries_breakdown --workload load --num $num --index blinkhash --threads $t --hyper --earliest --insert_only --tail_cache $tail >> ${path_breakdown}/blinkhash_tail_${tail}.${t}
+	done
+done
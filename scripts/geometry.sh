@@ -0,0 +1,20 @@
+#!/bin/bash
+
+## insert throughput, split frequency and footprint per blinkhash node geometry
+## (index/blink-hash/test/geometry.cpp, built with the blinkhash library)
+
+mkdir output
+mkdir output/geometry
+output_geo=output/geometry
+
+bin=./index/blink-hash/build/test/geometry
+threads="1 4 8 16 32 64"
+iterations="1 2 3"
+num=100000000
+
+for iter in $iterations; do
+	for t in $threads; do
+		echo "---------------- running with threads $t ----------------" >> ${output_geo}/geometry
+		$bin $num $t >> ${output_geo}/geometry
+	done
+done
@@ -58,3 +58,13 @@ for iter in $iterations; do
 		done
 	done
 done
+
+## timeseries keys --- blinkhash with background conversion of hash leaves
+for iter in $iterations; do
+        for wk in scan mixed; do
+		for t in $threads; do
+			echo "---------------- running with threads $t ----------------" >> ${output_ts}/blinkhash_bg_convert_${wk}
+			./bin/timeseries --index blinkhash --num $num --workload $wk --threads $t --hyper --earliest --latency 0.001 --bg_convert >> ${output_ts}/blinkhash_bg_convert_${wk}
+		done
+        done
+done
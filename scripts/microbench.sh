@@ -55,3 +55,17 @@ for iter in $iterations; do
 		done
 	done
 done
+
+## per-thread epoch handle in blinkhash (reused vs. per operation)
+path_attach=output/microbench/attach
+mkdir $path_attach
+for iter in $iterations; do
+	for wk in $workloads; do
+		for attach in true false; do
+			for t in $threads; do
+				echo "------------------- running with $t threads -------------------------" >> ${path_attach}/blinkhash_${wk}_attach_${attach}
+				./bin/microbench --workload $wk --init_num $init_num --run_num $run_num --index blinkhash --threads $t --attach=${attach} --latency 0.001 --hyper --earliest >> ${path_attach}/blinkhash_${wk}_attach_${attach}
+			done
+		done
+	done
+done
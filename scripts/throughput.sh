@@ -66,3 +66,15 @@ for iter in $iterations; do
                 done
         done
 done
+
+## timeseries keys --- scans with fixed range
+for iter in $iterations; do
+	for r in 10 100 1000; do
+		for idx in $index; do
+			for t in $threads; do
+				echo "---------------- running with threads $t ----------------" >> ${output_ts}/${idx}_scan_range${r}
+				./bin/timeseries --index $idx --num $num --workload scan --scan_range $r --threads $t --hyper --earliest >> ${output_ts}/${idx}_scan_range${r}
+			done
+		done
+	done
+done
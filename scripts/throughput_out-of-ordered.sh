@@ -36,6 +36,15 @@ for iter in $iterations; do
 	done
 done
 
+## blinkhash -- older leaves overflowed by late keys convert to btree leaves instead of splitting (footprint and split counts)
+overflow_util="0 0.6 0.8"
+for iter in $iterations; do
+	for fuzzy in $insert_fuzzy_rate; do
+		for util in $overflow_util; do
+			./bin/timeseries --index blinkhash --num $num --workload load --threads $t --hyper --earliest --insert_only --fuzzy $fuzzy --overflow_util $util >> ${output_out}/insert_blinkhash_overflow${util}_${fuzzy}
+		done
+	done
+done
 
 ## blinkbufferbatch -- monotonic fuzzy insertion
 for iter in $iterations; do
@@ -53,6 +53,8 @@ static bool earliest = false;
 static bool measure_latency = false;
 static float sampling_rate = 0;
 static float skew_factor = 1.2;
+// Whether blinkhash caches a per-thread epoch handle (false = one per operation)
+static bool attach_thread = true;
 
 // We could set an upper bound of the number of loaded keys
 static int64_t max_init_key = -1;
@@ -116,7 +118,11 @@ inline void load(int wl, int index_type, kvpair_t<keytype>* init_kv, int& init_n
 //==============================================================
 inline void exec(int wl, int index_type, int num_thread, kvpair_t<keytype>* init_kv, int init_num, kvpair_t<keytype>* run_kv, int run_num, int* ranges){
 
-    Index<keytype, keycomp> *idx = getInstance<keytype, keycomp>(index_type, key_type);
+    Index<keytype, keycomp> *idx;
+    if(index_type == TYPE_BLINKHASH && !attach_thread)
+	idx = new BlinkHashIndex<keytype, keycomp>(key_type, false);
+    else
+	idx = getInstance<keytype, keycomp>(index_type, key_type);
 
     std::vector<std::chrono::high_resolution_clock::time_point> local_load_latency[num_thread];
     if(measure_latency){
@@ -407,7 +413,7 @@ inline void exec(int wl, int index_type, int num_thread, kvpair_t<keytype>* init
 	threadinfo *ti = threadinfo::make(threadinfo::TI_MAIN, -1);
 	for(int i=start; i<end; i++){
 	    auto ret = idx->find(init_kv[i].key, &v, ti);
-	    if(v[0] != init_kv[i].value){
+	    if(v.empty() || (v[0] != init_kv[i].value)){
 		std::cout << "found wrong value" << std::endl;
 		exit(0);
 	    }
@@ -991,6 +997,7 @@ int main(int argc, char *argv[]) {
 	    ("hyper", "Enable hyper threading", cxxopts::value<bool>()->default_value((opt.hyper ? "true" : "false")))
 	    ("insert_only", "Skip running transactions", cxxopts::value<bool>()->default_value((opt.insert_only ? "true" : "false")))
 	    ("earliest", "Measure performance based on the earliest finished thread", cxxopts::value<bool>()->default_value((opt.earliest ? "true" : "false")))
+	    ("attach", "Reuse per-thread epoch handle in blinkhash", cxxopts::value<bool>()->default_value((opt.attach ? "true" : "false")))
 	    ("help", "Print help")
 	    ;
 
@@ -1043,6 +1050,9 @@ int main(int argc, char *argv[]) {
 	if(result.count("earliest"))
 	    opt.earliest = result["earliest"].as<bool>();
 
+	if(result.count("attach"))
+	    opt.attach = result["attach"].as<bool>();
+
     }catch(const cxxopts::OptionException& e){
 	std::cout << "Error parsing options: " << e.what() << std::endl;
 	exit(0);
@@ -1127,6 +1137,11 @@ int main(int argc, char *argv[]) {
     else
 	earliest = false;
 
+    if(opt.attach == true)
+	attach_thread = true;
+    else
+	attach_thread = false;
+
     int init_num, run_num;
     if(opt.init_num != 0){
 	init_num = opt.init_num;
@@ -57,6 +57,24 @@ static uint64_t fuzzy = 0;
 static uint64_t frequency = 2600; 
 // Random insertion rate
 static float random_rate = 0;
+// Number of keys per batched insert (1 = per-key insert)
+static uint32_t batch_size = 1;
+// Number of keys per batched point read (1 = per-key read)
+static uint32_t read_batch_size = 1;
+// Whether blinkhash converts hash leaves in a background thread
+static bool background_convert = false;
+// Whether blinkhash sends inserts beyond the rightmost leaf straight to it
+static bool tail_cache = true;
+// Whether blinkhash migrates buckets linked by leaf splits in a background thread
+static bool sweeper = false;
+// Utilization above which blinkhash converts a full older hash leaf instead of splitting it (0 = split)
+static float overflow_util = 0;
+// Number of sorted historical keys loaded before the workload, as a restart does (0 = none)
+static size_t startup_num = 0;
+// Whether the historical keys are bulk loaded by indexes that can (blinkhash) instead of inserted
+static bool use_bulk_load = true;
+// Fixed range of scan operations (0 = random range up to 100)
+static uint32_t scan_length = 0;
 
 // We could set an upper bound of the number of loaded keys
 static int64_t max_init_key = -1;
@@ -88,7 +106,43 @@ size_t MemUsage() {
 
 
 inline void run(int index_type, int wl, int num_thread, int num){
-    Index<keytype, keycomp>* idx = getInstance<keytype, keycomp>(index_type, key_type);
+    Index<keytype, keycomp>* idx;
+    if(index_type == TYPE_BLINKHASH && (background_convert || !tail_cache || sweeper || (overflow_util > 0)))
+	idx = new BlinkHashIndex<keytype, keycomp>(key_type, true, background_convert, tail_cache, sweeper, overflow_util);
+    else
+	idx = getInstance<keytype, keycomp>(index_type, key_type);
+    // startup: historical keys, sorted and older than any key of the workload
+    std::vector<kvpair_t<keytype>> history(startup_num);
+    if(startup_num){
+	auto base = Rdtsc() - startup_num;
+	for(size_t i=0; i<startup_num; i++){
+	    history[i].key = (base + i) << 16;
+	    history[i].value = reinterpret_cast<uint64_t>(&history[i].key);
+	}
+
+	auto insert_history = [idx, num_thread, &history](uint64_t thread_id, bool){
+	    threadinfo *ti = threadinfo::make(threadinfo::TI_MAIN, -1);
+	    size_t chunk = history.size() / num_thread;
+	    size_t start = chunk * thread_id;
+	    size_t end = (thread_id == num_thread-1) ? history.size() : chunk * (thread_id + 1);
+	    for(auto i=start; i<end; i++){
+		idx->insert(history[i].key, history[i].value, ti);
+		if((i - start) % 4096 == 0)
+		    ti->rcu_quiesce();
+	    }
+	    ti->rcu_quiesce();
+	};
+
+	double start_time = get_now();
+	bool bulk = use_bulk_load && idx->bulk_load(history.data(), startup_num, num_thread);
+	if(!bulk)
+	    StartThreads(idx, num_thread, insert_history, false);
+	double end_time = get_now();
+	std::cout << "Startup " << startup_num / (end_time - start_time) / 1000000 << (bulk ? " (bulk load)" : " (insert)") << std::endl;
+	if(index_type == TYPE_BLINKHASH)
+	    idx->getMemory();
+    }
+
     std::vector<std::chrono::high_resolution_clock::time_point> local_load_latency[num_thread];
     if(measure_latency){
 	for(int i=0; i<num_thread; i++){
@@ -148,6 +202,7 @@ inline void run(int index_type, int wl, int num_thread, int num){
 	#endif
 	int gc_counter = 0;
 	int sensor_id = 0;
+	int batch_start = 0;
 
 	PerfEventBlock e;
 	if(insert_only && profile){
@@ -170,17 +225,30 @@ inline void run(int index_type, int wl, int num_thread, int num){
 		kv[j].value = reinterpret_cast<uint64_t>(&kv[j].key);
 	    }
 
+	    // batched keys are only sampled around the insert_batch call that flushes them, as the latency per key
+	    bool flush = (batch_size > 1) && ((j+1 - batch_start == batch_size) || (i+1 == end));
 	    bool measure_latency_ = false;
-	    if(measure_latency)
+	    if(measure_latency && ((batch_size == 1) || flush))
 		measure_latency_ = random_bool();
 	    
+	    std::chrono::high_resolution_clock::time_point latency_start;
 	    if(measure_latency_)
-		local_load_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
-
-	    idx->insert(kv[j].key, kv[j].value, ti);
+		latency_start = std::chrono::high_resolution_clock::now();
+
+	    int batch_num = 1;
+	    if(batch_size == 1)
+		idx->insert(kv[j].key, kv[j].value, ti);
+	    else if(flush){
+		batch_num = j+1 - batch_start;
+		idx->insert_batch(&kv[batch_start], batch_num, ti);
+		batch_start = j+1;
+	    }
 
-	    if(measure_latency_)
-		local_load_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
+	    if(measure_latency_){
+		auto latency_end = std::chrono::high_resolution_clock::now();
+		local_load_latency[thread_id].push_back(latency_start);
+		local_load_latency[thread_id].push_back(latency_start + (latency_end - latency_start) / batch_num);
+	    }
 
 	    gc_counter++;
 	    if(gc_counter % 4096 == 0) {
@@ -196,7 +264,7 @@ inline void run(int index_type, int wl, int num_thread, int num){
 		    e.stopCounters();
 		    perf_block[thread_id] = e;
 		}
-		inserted_num[thread_id] = j;
+		inserted_num[thread_id] = (batch_size == 1) ? j : batch_start;
 		outoforder[thread_id] = idx->get_outoforder();
 		#ifdef BREAKDOWN
 		idx->get_breakdown(time.traversal, time.abort, time.latch, time.node, time.split, time.consolidation);
@@ -234,6 +302,7 @@ inline void run(int index_type, int wl, int num_thread, int num){
 	#endif
 	int gc_counter = 0;
 	int sensor_id = 0;
+	int batch_start = 0;
 
 	PerfEventBlock e;
         if(insert_only && profile){
@@ -256,17 +325,30 @@ inline void run(int index_type, int wl, int num_thread, int num){
 		kv[j].value = reinterpret_cast<uint64_t>(&kv[j].key);
 	    }
 
+	    // batched keys are only sampled around the insert_batch call that flushes them, as the latency per key
+	    bool flush = (batch_size > 1) && ((j+1 - batch_start == batch_size) || (i+1 == end));
 	    bool measure_latency_ = false;
-	    if(measure_latency)
+	    if(measure_latency && ((batch_size == 1) || flush))
 		measure_latency_ = random_bool();
 	    
+	    std::chrono::high_resolution_clock::time_point latency_start;
 	    if(measure_latency_)
-		local_load_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
-
-	    idx->insert(kv[j].key, kv[j].value, ti);
+		latency_start = std::chrono::high_resolution_clock::now();
+
+	    int batch_num = 1;
+	    if(batch_size == 1)
+		idx->insert(kv[j].key, kv[j].value, ti);
+	    else if(flush){
+		batch_num = j+1 - batch_start;
+		idx->insert_batch(&kv[batch_start], batch_num, ti);
+		batch_start = j+1;
+	    }
 
-	    if(measure_latency_)
-		local_load_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
+	    if(measure_latency_){
+		auto latency_end = std::chrono::high_resolution_clock::now();
+		local_load_latency[thread_id].push_back(latency_start);
+		local_load_latency[thread_id].push_back(latency_start + (latency_end - latency_start) / batch_num);
+	    }
 
 	    gc_counter++;
 	    if(gc_counter % 4096 == 0) {
@@ -388,6 +470,10 @@ inline void run(int index_type, int wl, int num_thread, int num){
     #endif
     if(insert_only == true) {
 	//idx->getMemory();
+	if(index_type == TYPE_BLINKHASH){
+	    idx->CollectStatisticalCounter(num_thread);
+	    idx->getMemory();
+	}
 	idx->find_depth();
 	idx->AfterLoadCallback();
 	idx->find_depth();
@@ -489,6 +575,9 @@ inline void run(int index_type, int wl, int num_thread, int num){
 
 	std::vector<uint64_t> v;
 	v.reserve(5);
+	keytype batch_keys[read_batch_size];
+	uint64_t batch_values[read_batch_size];
+	bool batch_found[read_batch_size];
 	for(auto i=start; i<end; i++){
 	    bool measure_latency_ = false;
 	    if(measure_latency)
@@ -497,12 +586,23 @@ inline void run(int index_type, int wl, int num_thread, int num){
 	    if(measure_latency_)
 		local_run_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
 
-	    #ifdef BWTREE_USE_MAPPING_TABLE
-	    idx->find(ops[i].first.key, &v, ti);
-	    #else
-	    idx->find_bwtree_fast(ops[i].first.key, &v);
-	    #endif
-	    v.clear();
+	    if(read_batch_size > 1){
+		// the first read of each batch issues the whole batch
+		if((i - start) % read_batch_size == 0){
+		    int n = std::min<size_t>(read_batch_size, end - i);
+		    for(int k=0; k<n; k++)
+			batch_keys[k] = ops[i+k].first.key;
+		    idx->find_batch(batch_keys, batch_values, batch_found, n, ti);
+		}
+	    }
+	    else{
+		#ifdef BWTREE_USE_MAPPING_TABLE
+		idx->find(ops[i].first.key, &v, ti);
+		#else
+		idx->find_bwtree_fast(ops[i].first.key, &v);
+		#endif
+		v.clear();
+	    }
 
 	    if(measure_latency_)
 		local_run_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
@@ -564,6 +664,9 @@ inline void run(int index_type, int wl, int num_thread, int num){
 
 	std::vector<uint64_t> v;
 	v.reserve(5);
+	keytype batch_keys[read_batch_size];
+	uint64_t batch_values[read_batch_size];
+	bool batch_found[read_batch_size];
 	for(auto i=start; i<end; i++){
 	    bool measure_latency_ = false;
 	    if(measure_latency)
@@ -572,12 +675,23 @@ inline void run(int index_type, int wl, int num_thread, int num){
 	    if(measure_latency_)
 		local_run_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
 
-	    #ifdef BWTREE_USE_MAPPING_TABLE
-	    idx->find(ops[i].first.key, &v, ti);
-	    #else
-	    idx->find_bwtree_fast(ops[i].first.key, &v);
-	    #endif
-	    v.clear();
+	    if(read_batch_size > 1){
+		// the first read of each batch issues the whole batch
+		if((i - start) % read_batch_size == 0){
+		    int n = std::min<size_t>(read_batch_size, end - i);
+		    for(int k=0; k<n; k++)
+			batch_keys[k] = ops[i+k].first.key;
+		    idx->find_batch(batch_keys, batch_values, batch_found, n, ti);
+		}
+	    }
+	    else{
+		#ifdef BWTREE_USE_MAPPING_TABLE
+		idx->find(ops[i].first.key, &v, ti);
+		#else
+		idx->find_bwtree_fast(ops[i].first.key, &v);
+		#endif
+		v.clear();
+	    }
 
 	    if(measure_latency_)
 		local_run_latency[thread_id].push_back(std::chrono::high_resolution_clock::now());
@@ -601,7 +715,7 @@ inline void run(int index_type, int wl, int num_thread, int num){
 
     auto scan_range = new int[num];
     for(int i=0; i<num; i++){
-	scan_range[i] = rand() % 100;
+	scan_range[i] = (scan_length != 0) ? scan_length : rand() % 100;
     }
     auto scan_earliest = [idx, num, num_thread, &earliest_finished, &run_num, &local_run_latency, ops, &scan_range, &params, &perf_block, &breakdown](uint64_t thread_id, bool){
 	auto random_bool = std::bind(std::bernoulli_distribution(sampling_rate), std::knuth_b());
@@ -995,6 +1109,9 @@ inline void run(int index_type, int wl, int num_thread, int num){
         }
     }
 
+    if(index_type == TYPE_BLINKHASH)
+	idx->CollectStatisticalCounter(num_thread);
+
     #ifdef BREAKDOWN
     {
 	uint64_t time_traversal=0, time_abort=0, time_latch=0, time_node=0, time_split=0, time_consolidation=0;
@@ -1048,6 +1165,15 @@ int main(int argc, char *argv[]) {
 	    ("earliest", "Measure performance based on the earliest finished thread", cxxopts::value<bool>()->default_value((opt.earliest ? "true" : "false")))
 	    ("fuzzy", "Fuzzy insertion latency in (usec)", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.fuzzy)))
 	    ("random", "Amount of random insertion", cxxopts::value<float>()->default_value(std::to_string(opt.random)))
+	    ("batch", "Number of keys per batched insert (1-1024)", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.batch)))
+	    ("read_batch", "Number of keys per batched read in the read workload (1-1024)", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.read_batch)))
+	    ("scan_range", "Fixed range of scan operations (0 = random up to 100)", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.scan_range)))
+	    ("bg_convert", "Convert hash leaves in a background thread (blinkhash)", cxxopts::value<bool>()->default_value((opt.bg_convert ? "true" : "false")))
+	    ("tail_cache", "Insert beyond the cached rightmost leaf without traversal (blinkhash)", cxxopts::value<bool>()->default_value((opt.tail_cache ? "true" : "false")))
+	    ("sweeper", "Migrate buckets linked by leaf splits in a background thread (blinkhash)", cxxopts::value<bool>()->default_value((opt.sweeper ? "true" : "false")))
+	    ("overflow_util", "Convert a full older hash leaf at least this utilized instead of splitting it, 0 = split (blinkhash)", cxxopts::value<float>()->default_value(std::to_string(opt.overflow_util)))
+	    ("startup", "Number of sorted historical keys in million records loaded before the workload, 0 = none", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.startup)))
+	    ("bulk_load", "Bulk load the historical keys instead of inserting them (blinkhash)", cxxopts::value<bool>()->default_value((opt.bulk_load ? "true" : "false")))
 	    ("help", "Print help")
 	    ;
 
@@ -1072,6 +1198,33 @@ int main(int argc, char *argv[]) {
 	if(result.count("random"))
 	    opt.random = result["random"].as<float>();
 
+	if(result.count("batch"))
+	    opt.batch = result["batch"].as<uint32_t>();
+
+	if(result.count("read_batch"))
+	    opt.read_batch = result["read_batch"].as<uint32_t>();
+
+	if(result.count("scan_range"))
+	    opt.scan_range = result["scan_range"].as<uint32_t>();
+
+	if(result.count("bg_convert"))
+	    opt.bg_convert = result["bg_convert"].as<bool>();
+
+	if(result.count("tail_cache"))
+	    opt.tail_cache = result["tail_cache"].as<bool>();
+
+	if(result.count("sweeper"))
+	    opt.sweeper = result["sweeper"].as<bool>();
+
+	if(result.count("overflow_util"))
+	    opt.overflow_util = result["overflow_util"].as<float>();
+
+	if(result.count("startup"))
+	    opt.startup = result["startup"].as<uint32_t>();
+
+	if(result.count("bulk_load"))
+	    opt.bulk_load = result["bulk_load"].as<bool>();
+
 	if(result.count("num"))
 	    opt.num = result["num"].as<uint32_t>();
 	else{
@@ -1215,6 +1368,31 @@ int main(int argc, char *argv[]) {
     }
     random_rate = opt.random;
 
+    if(opt.batch < 1 || opt.batch > 1024){
+	std::cout << "Batch size should be between 1 and 1024" << std::endl;
+	exit(0);
+    }
+    batch_size = opt.batch;
+
+    if(opt.read_batch < 1 || opt.read_batch > 1024){
+	std::cout << "Read batch size should be between 1 and 1024" << std::endl;
+	exit(0);
+    }
+    read_batch_size = opt.read_batch;
+
+    scan_length = opt.scan_range;
+
+    if(opt.bg_convert == true)
+	background_convert = true;
+    else
+	background_convert = false;
+
+    tail_cache = opt.tail_cache;
+    sweeper = opt.sweeper;
+    overflow_util = opt.overflow_util;
+    startup_num = (size_t)opt.startup * 1000000;
+    use_bulk_load = opt.bulk_load;
+
 
     int num_thread = opt.threads;
     num *= 1000000;
@@ -495,7 +495,7 @@ inline void exec(int wl, int index_type, int num_thread, kvpair_t<keytype>* init
 	threadinfo *ti = threadinfo::make(threadinfo::TI_MAIN, -1);
 	for(int i=start; i<end; i++){
 	    auto ret = idx->find(init_kv[i].key, &v, ti);
-	    if(v[0] != init_kv[i].value){
+	    if(v.empty() || (v[0] != init_kv[i].value)){
 		std::cout << "found wrong value" << std::endl;
 		exit(0);
 	    }